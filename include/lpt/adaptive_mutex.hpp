@@ -0,0 +1,136 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  \brief Spin then park on a futex; Linux, C++20
+ *
+ */
+
+#ifndef INCLUDED_adaptive_mutex_hpp_0a9c4e63_b2d7_4f18_8e5a_6d31c7f92b04
+#define INCLUDED_adaptive_mutex_hpp_0a9c4e63_b2d7_4f18_8e5a_6d31c7f92b04
+
+#pragma once
+
+#include <lpt/cpu.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace lpt {
+
+namespace detail {
+
+inline void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected) noexcept
+{
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+inline void futex_wake_one(std::atomic<std::uint32_t>& word) noexcept
+{
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+} // namespace detail
+
+
+/*
+ * Three states (Drepper, "Futexes Are Tricky"): unlocked, locked, locked
+ * with sleepers. Uncontended lock and unlock are one atomic op each and
+ * no syscall.
+ *
+ * Contended: spin with exponential backoff up to an adaptive budget, then
+ * sleep on the futex. As glibc's PTHREAD_MUTEX_ADAPTIVE_NP, the budget
+ * follows the spins that recently got the lock, capped by
+ * lpt::cpu::spin_budget().
+ */
+class adaptive_mutex
+{
+public:
+
+    adaptive_mutex()  = default;
+    ~adaptive_mutex() = default;
+
+    adaptive_mutex(const adaptive_mutex&)            = delete;
+    adaptive_mutex& operator=(const adaptive_mutex&) = delete;
+    adaptive_mutex(adaptive_mutex&&)                 = delete;
+    adaptive_mutex& operator=(adaptive_mutex&&)      = delete;
+
+    void lock() noexcept
+    {
+        std::uint32_t expected(UNLOCKED);
+        if ( ! _state.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed)) {
+            lock_contended();
+        }
+    }
+
+    bool try_lock() noexcept
+    {
+        std::uint32_t expected(UNLOCKED);
+        return _state.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        if (_state.exchange(UNLOCKED, std::memory_order_release) == SLEEPERS) {
+            detail::futex_wake_one(_state);
+        }
+    }
+
+private:
+
+    enum : std::uint32_t { UNLOCKED, LOCKED, SLEEPERS };
+
+    static constexpr unsigned MAX_BACKOFF = 64;
+
+    void lock_contended() noexcept
+    {
+        const unsigned maxSpins(std::min(2 * _spins.load(std::memory_order_relaxed) + 16, lpt::cpu::spin_budget()));
+
+        unsigned spins(0);
+        for (unsigned backoff = 1; spins < maxSpins; spins += backoff, backoff = std::min(2 * backoff, MAX_BACKOFF)) {
+            for (unsigned i = 0; i < backoff; ++i) {
+                lpt::cpu::relax();
+            }
+            std::uint32_t state(_state.load(std::memory_order_relaxed));
+            if (state == SLEEPERS) {
+                break;  // do not jump ahead of them
+            }
+            if (state == UNLOCKED
+             && _state.compare_exchange_weak(state, LOCKED, std::memory_order_acquire, std::memory_order_relaxed)) {
+                adapt(spins);
+                return;
+            }
+        }
+        adapt(maxSpins);
+
+        // Whoever takes the lock from here on also assumes there are sleepers
+        while (_state.exchange(SLEEPERS, std::memory_order_acquire) != UNLOCKED) {
+            detail::futex_wait(_state, SLEEPERS);
+        }
+    }
+
+    // Exponential moving average, 1/8 weight
+    void adapt(unsigned spins) noexcept
+    {
+        const unsigned avg(_spins.load(std::memory_order_relaxed));
+        _spins.store(avg + (static_cast<int>(spins) - static_cast<int>(avg)) / 8, std::memory_order_relaxed);
+    }
+
+private:
+
+    std::atomic<std::uint32_t> _state{UNLOCKED};
+    std::atomic<unsigned>      _spins{0};
+
+}; // adaptive_mutex
+
+} //namespace lpt
+
+
+#endif //#define INCLUDED_adaptive_mutex_hpp_0a9c4e63_b2d7_4f18_8e5a_6d31c7f92b04
@@ -0,0 +1,157 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  \brief Admission filters for lru_array; C++20
+ *
+ */
+
+#ifndef INCLUDED_admission_hpp_d4a7c3e1_5f28_4b90_8e6d_1c2b9a7f30e5
+#define INCLUDED_admission_hpp_d4a7c3e1_5f28_4b90_8e6d_1c2b9a7f30e5
+
+#pragma once
+
+#include <lpt/cpu.hpp>
+#include <lpt/eviction.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace lpt {
+
+/*
+ * Admission filters: when the container is full, decide whether a new
+ * key may replace the victim chosen by the eviction policy.
+ *
+ *     void on_access(std::uint64_t keyHash);     // every lookup and push
+ *     bool admit(std::uint64_t candidateHash, std::uint64_t victimHash);
+ */
+namespace admission {
+
+/*
+ * Admit everything: plain eviction policy.
+ */
+template <std::size_t N>
+struct always
+{
+    void on_access(std::uint64_t /*hash*/) noexcept {}
+    bool admit(std::uint64_t /*candidate*/, std::uint64_t /*victim*/) const noexcept { return true; }
+};
+
+/*
+ * TinyLFU (Einziger et al., ACM ToS'17): admit the candidate only if it
+ * was seen more often than the victim.
+ *
+ * Frequencies live in a count-min sketch of 4-bit counters. All 4
+ * counters of a key are in the same cache line, one per 64-bit word
+ * pair. Every 10*N accesses all counters are halved so that the sketch
+ * forgets old popularity.
+ */
+template <std::size_t N>
+class tinylfu
+{
+public:
+
+    static constexpr std::size_t   WORDS_PER_BLOCK = lpt::cpu::cache_line_size / sizeof(std::uint64_t);
+    static constexpr std::size_t   BLOCKS          = std::max<std::size_t>(std::bit_ceil(N) / WORDS_PER_BLOCK, 1);
+    static constexpr std::size_t   SAMPLE_SIZE     = 10 * std::max<std::size_t>(N, 1);
+    static constexpr std::uint8_t  MAX_COUNT       = 15;
+
+    static_assert(WORDS_PER_BLOCK == 8, "4 word pairs per block");
+
+    void on_access(std::uint64_t hash) noexcept
+    {
+        const std::uint64_t h(spread(hash));
+        auto&               b(block(h));
+
+        bool added(false);
+        for (unsigned i = 0; i < 4; ++i) {
+            const auto [word, shift] = counter(h, i);
+            if (((b[word] >> shift) & MAX_COUNT) < MAX_COUNT) {
+                b[word] += std::uint64_t(1) << shift;
+                added = true;
+            }
+        }
+
+        if (added && ++_samples == SAMPLE_SIZE) {
+            age();
+        }
+    }
+
+    /// Estimated number of accesses, at most 15
+    std::uint8_t frequency(std::uint64_t hash) const noexcept
+    {
+        const std::uint64_t h(spread(hash));
+        const auto&         b(block(h));
+
+        std::uint8_t freq(MAX_COUNT);
+        for (unsigned i = 0; i < 4; ++i) {
+            const auto [word, shift] = counter(h, i);
+            freq = std::min<std::uint8_t>(freq, (b[word] >> shift) & MAX_COUNT);
+        }
+        return freq;
+    }
+
+    bool admit(std::uint64_t candidate, std::uint64_t victim) const noexcept
+    {
+        return frequency(candidate) > frequency(victim);
+    }
+
+private:
+
+    struct alignas(lpt::cpu::cache_line_size) block_t : std::array<std::uint64_t, WORDS_PER_BLOCK> {};
+
+    struct position
+    {
+        unsigned _word;
+        unsigned _shift;
+    };
+
+    // The container indexes with the low bits of the same hash
+    static constexpr std::uint64_t spread(std::uint64_t hash) noexcept
+    {
+        return detail::mix_hash(hash ^ 0x9e3779b97f4a7c15ULL);
+    }
+
+    // Counter i is in word pair i; 1 bit picks the word, 4 bits the nibble
+    static constexpr position counter(std::uint64_t h, unsigned i) noexcept
+    {
+        const unsigned bits(static_cast<unsigned>(h >> (8 * i)));
+        return {2*i + (bits & 1), 4 * ((bits >> 1) & 15)};
+    }
+
+    block_t& block(std::uint64_t h) noexcept
+    {
+        return _blocks[(h >> 32) & (BLOCKS - 1)];
+    }
+
+    const block_t& block(std::uint64_t h) const noexcept
+    {
+        return _blocks[(h >> 32) & (BLOCKS - 1)];
+    }
+
+    void age() noexcept
+    {
+        for (auto& b : _blocks) {
+            for (auto& w : b) {
+                w = (w >> 1) & 0x7777777777777777ULL;
+            }
+        }
+        _samples /= 2;
+    }
+
+    std::array<block_t, BLOCKS> _blocks{};
+    std::size_t                 _samples = 0;
+
+}; // tinylfu
+
+} // namespace admission
+
+} //namespace lpt
+
+
+#endif //#define INCLUDED_admission_hpp_d4a7c3e1_5f28_4b90_8e6d_1c2b9a7f30e5
@@ -9,12 +9,31 @@
 
 #pragma once 
 
+#include <lpt/constexpr_string.hpp>
+#include <lpt/cpu.hpp>
+#include <lpt/thread_slots.hpp>
+
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
+#include <time.h>
 #include <unistd.h>  // _POSIX_TIMERS
 
+#if defined(__x86_64__) || defined(__i386__)
+#  include <cpuid.h>
+#  include <x86intrin.h>
+#endif
+
 using namespace std::string_literals;
 
 namespace lpt { namespace chrono {
@@ -114,6 +133,128 @@ protected:
     struct timespec         _start;
 }; // std_timepoint
 
+#if defined(__x86_64__) || defined(__i386__)
+/*
+ * Time stamp counter: a few ns to read instead of ~20 for a vDSO
+ * clock_gettime. Ticks are converted with a scale measured once against
+ * CLOCK_MONOTONIC_RAW, on first use (~10 ms).
+ *
+ * Trust it only if invariant(): otherwise the TSC rate follows frequency
+ * changes and may stop in deep C-states.
+ *
+ * \code
+ *     lpt::chrono::measurement<decltype(f), lpt::chrono::tsc_timepoint> m("tag", f);
+ * \endcode
+ */
+class tsc_timepoint : public timepoint_base
+{
+public:
+
+    tsc_timepoint() : _ticks(start()) {}
+
+    ~tsc_timepoint()                               = default;
+    tsc_timepoint(const tsc_timepoint&)            = default;
+    tsc_timepoint& operator=(const tsc_timepoint&) = default;
+    tsc_timepoint(tsc_timepoint&&)                 = default;
+    tsc_timepoint& operator=(tsc_timepoint&&)      = default;
+
+    auto elapsed() const
+    {
+        return duration_t(static_cast<duration_t::rep>((stop() - _ticks) * ns_per_tick()));
+    }
+
+    static percent_t as_percent_of(duration_t dataPoint, duration_t baseDuration)
+    {
+        return ((dataPoint - baseDuration)/(baseDuration*(percent_t)1.0)) * 100.0;
+    }
+
+    percent_t as_percent_of(duration_t baseDuration) const
+    {
+        return as_percent_of(elapsed(), baseDuration);
+    }
+
+    /// CPUID.80000007H:EDX[8]: constant rate, runs in all ACPI states
+    static bool invariant() noexcept
+    {
+        unsigned a, b, c, d;
+        return __get_cpuid(0x80000007, &a, &b, &c, &d) && (d & (1u << 8));
+    }
+
+    static double ns_per_tick() noexcept
+    {
+        static const double scale = calibrate();
+        return scale;
+    }
+
+private:
+
+    // Earlier instructions complete before reading the TSC, later ones do not start before
+    static std::uint64_t start() noexcept
+    {
+        _mm_lfence();
+        const std::uint64_t t(__rdtsc());
+        _mm_lfence();
+        return t;
+    }
+
+    // rdtscp waits for earlier instructions; lfence holds back later ones
+    static std::uint64_t stop() noexcept
+    {
+        unsigned            aux;
+        const std::uint64_t t(__rdtscp(&aux));
+        _mm_lfence();
+        return t;
+    }
+
+    static std::int64_t raw_ns() noexcept
+    {
+        struct timespec ts;
+        ::clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        return ts.tv_sec * static_cast<std::int64_t>(NANOSECS) + ts.tv_nsec;
+    }
+
+    static double calibrate() noexcept
+    {
+        const std::int64_t  ns0(raw_ns());
+        const std::uint64_t t0(start());
+        std::int64_t        ns1(ns0);
+        while (ns1 - ns0 < 10'000'000) {
+            ns1 = raw_ns();
+        }
+        const std::uint64_t t1(stop());
+        return static_cast<double>(ns1 - ns0) / static_cast<double>(t1 - t0);
+    }
+
+    std::uint64_t           _ticks;
+}; // tsc_timepoint
+#endif // x86
+
+/*
+ * The time of the last kernel tick (1-4 ms resolution), cached by the
+ * kernel: cheaper than steady_clock. For timeouts and expiries, not for
+ * measurements.
+ */
+struct coarse_clock
+{
+    using duration   = std::chrono::nanoseconds;
+    using rep        = duration::rep;
+    using period     = duration::period;
+    using time_point = std::chrono::time_point<coarse_clock>;
+
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept
+    {
+#ifdef CLOCK_MONOTONIC_COARSE
+        struct timespec ts;
+        ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return time_point(duration(ts.tv_sec * timepoint_base::NANOSECS + ts.tv_nsec));
+#else
+        return time_point(std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()));
+#endif
+    }
+}; // coarse_clock
+
 #ifdef _POSIX_TIMERS
 using timepoint = std_timepoint; //posix_timepoint;
 #else
@@ -121,16 +262,75 @@ using timepoint = std_timepoint;
 #endif  // _POSIX_TIMERS
 
 
+/*
+ * The cost of timing an empty region with TIMEPOINT: a floor under every
+ * sample, which matters for regions of a few dozen ns. Measured once,
+ * at first use, over many runs; subtract the median, e.g. with
+ * lpt::chrono::dataset::subtract().
+ */
+template <typename TIMEPOINT = timepoint>
+struct calibration
+{
+    timepoint::duration_t _min{};
+    timepoint::duration_t _median{};
+
+    static calibration measure(unsigned runs = 10'001)
+    {
+        std::vector<timepoint::duration_t::rep> samples(runs);
+        for (unsigned i = 0; i < runs / 10; ++i) {  // warm up
+            const TIMEPOINT tp;
+            samples[i] = timepoint::duration_t(tp.elapsed()).count();
+        }
+        for (auto& sample : samples) {
+            const TIMEPOINT tp;
+            sample = timepoint::duration_t(tp.elapsed()).count();
+        }
+
+        auto mid(samples.begin() + runs / 2);
+        std::nth_element(samples.begin(), mid, samples.end());
+        calibration c;
+        c._median = timepoint::duration_t(*mid);
+        c._min    = timepoint::duration_t(*std::min_element(samples.begin(), samples.end()));
+        return c;
+    }
+
+    static const calibration& instance()
+    {
+        static const calibration c(measure());
+        return c;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const calibration& c)
+    {
+        os << "Measurement floor: min " << c._min.count() << ' ' << timepoint::unit()
+           << ", median " << c._median.count() << ' ' << timepoint::unit();
+        return os;
+    }
+}; // calibration
+
+
 // Do nothing functor
-static void noop(const std::string& /*tag*/, const timepoint::duration_t& /*dur*/) noexcept {}
-template <typename FUNC>
+inline void noop(std::string_view /*tag*/, const timepoint::duration_t& /*dur*/) noexcept {}
+
+/*
+ * @param TIMEPOINT std_timepoint, posix_timepoint, tsc_timepoint...
+ * @param TAG       std::string; or, to construct without allocating:
+ *                  lpt::constexpr_string<N>, held by value, or
+ *                  std::string_view to a tag that outlives the measurement.
+ *
+ * \code
+ *     lpt::chrono::measurement m1("Parse", report);                               // std::string
+ *     lpt::chrono::measurement m2(lpt::make_constexpr_string("Parse"), report);   // no allocation
+ * \endcode
+ */
+template <typename FUNC, typename TIMEPOINT = timepoint, typename TAG = std::string>
 class measurement 
 {
 public:
 
     /// Apply the @param func functor in the destructor
-    measurement(std::string      tag,
-                FUNC             func)
+    measurement(std::type_identity_t<TAG> tag,
+                FUNC                      func)
         : _tag(std::move(tag))
         , _func(std::move(func))
     { }
@@ -153,12 +353,21 @@ public:
 
 private:
 
-    const std::string       _tag;
-    const timepoint         _start;
+    const TAG               _tag;
+    const TIMEPOINT         _start;
     FUNC                    _func;
 
 }; // measurement
 
+template <std::uint16_t N, typename FUNC>
+measurement(constexpr_string<N>, FUNC) -> measurement<FUNC, timepoint, constexpr_string<N>>;
+
+template <typename FUNC>
+measurement(std::string_view, FUNC) -> measurement<FUNC, timepoint, std::string_view>;
+
+template <typename FUNC>
+measurement(const char*, FUNC) -> measurement<FUNC>;
+
 /**
  \code
     {
@@ -201,12 +410,13 @@ public:
         return _tag;
     }
 
+    template <typename TIMEPOINT = timepoint>
     auto measurement() 
     {
-        return lpt::chrono::measurement(_tag,
-                                        [& acc=*this](auto&& /*tag*/, auto&& dur) -> decltype(auto) {
-                                            acc += dur;
-                                        });
+        auto func([& acc=*this](auto&& /*tag*/, auto&& dur) -> decltype(auto) {
+            acc += dur;
+        });
+        return lpt::chrono::measurement<decltype(func), TIMEPOINT, std::string_view>(_tag, std::move(func));
     }
 
     accumulator& operator+=(const timepoint::duration_t& dur)
@@ -215,14 +425,16 @@ public:
         return *this;
     }
 
-    accumulator& operator+=(const timepoint& tp)
+    template <typename TIMEPOINT>
+        requires std::is_base_of_v<timepoint_base, TIMEPOINT>
+    accumulator& operator+=(const TIMEPOINT& tp)
     {
         _elapsed += tp.elapsed();
         return *this;
     }
 
-    template <typename FUNC>
-    accumulator& operator+=(const class measurement<FUNC>& m) // NOLINT
+    template <typename FUNC, typename TIMEPOINT, typename TAG>
+    accumulator& operator+=(const class measurement<FUNC, TIMEPOINT, TAG>& m) // NOLINT
     {
         _elapsed += m.elapsed(); // NOLINT
         return *this;
@@ -245,9 +457,152 @@ public:
 private:
 
     const std::string       _tag;
-    timepoint::duration_t   _elapsed;
+    timepoint::duration_t   _elapsed{};
 
 }; // accumulator
 
+/**
+ * As accumulator, for measurements from many threads. Each thread adds to
+ * its own cache line sized slot, registered on its first use; readers sum
+ * the slots. Adds are a relaxed load and store: no lock, no locked
+ * instruction, no line shared with another writer. Reads are O(threads)
+ * and may miss adds in flight.
+ *
+ * Slots outlive their threads, not the accumulator.
+ *
+ \code
+    lpt::chrono::concurrent_accumulator acc("Parse");
+    // any thread
+    {
+        auto m(acc.measurement());
+        parse(...);
+    }
+    std::cout << acc << std::endl; // total, calls, mean
+ \endcode
+*/
+class concurrent_accumulator 
+{
+public:
+
+    concurrent_accumulator(std::string tag)
+        : _tag(std::move(tag))
+    { }
+
+    ~concurrent_accumulator()                                        = default;
+
+    concurrent_accumulator(const concurrent_accumulator&)            = delete;
+    concurrent_accumulator& operator=(const concurrent_accumulator&) = delete;
+    concurrent_accumulator(concurrent_accumulator&&)                 = delete;
+    concurrent_accumulator& operator=(concurrent_accumulator&&)      = delete;
+
+    timepoint::duration_t elapsed() const
+    {
+        return timepoint::duration_t(totals()._elapsed);
+    }
+
+    /// Number of adds
+    std::uint64_t count() const
+    {
+        return static_cast<std::uint64_t>(totals()._count);
+    }
+
+    /// Per add; 0 without adds
+    timepoint::duration_t mean() const
+    {
+        const auto t(totals());
+        return timepoint::duration_t(t._count ? t._elapsed / t._count : 0);
+    }
+
+    const std::string& tag() const
+    {
+        return _tag;
+    }
+
+    struct totals_t
+    {
+        std::int64_t _elapsed = 0;
+        std::int64_t _count   = 0;
+    };
+
+    /// Elapsed and count of one pass over the slots, e.g. for a consistent mean
+    totals_t totals() const
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        totals_t t;
+        for (const auto& s : _slots) {
+            t._elapsed += s->_elapsed.load(std::memory_order_relaxed);
+            t._count   += s->_count.load(std::memory_order_relaxed);
+        }
+        return t;
+    }
+
+    template <typename TIMEPOINT = timepoint>
+    auto measurement() 
+    {
+        auto func([& acc=*this](auto&& /*tag*/, auto&& dur) -> decltype(auto) {
+            acc += dur;
+        });
+        return lpt::chrono::measurement<decltype(func), TIMEPOINT, std::string_view>(_tag, std::move(func));
+    }
+
+    concurrent_accumulator& operator+=(const timepoint::duration_t& dur)
+    {
+        slot_t& s(local());
+        s._elapsed.store(s._elapsed.load(std::memory_order_relaxed) + dur.count(), std::memory_order_relaxed);
+        s._count.store(s._count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return *this;
+    }
+
+    template <typename TIMEPOINT>
+        requires std::is_base_of_v<timepoint_base, TIMEPOINT>
+    concurrent_accumulator& operator+=(const TIMEPOINT& tp)
+    {
+        return *this += timepoint::duration_t(tp.elapsed());
+    }
+
+    template <typename FUNC, typename TIMEPOINT, typename TAG>
+    concurrent_accumulator& operator+=(const class measurement<FUNC, TIMEPOINT, TAG>& m) // NOLINT
+    {
+        return *this += timepoint::duration_t(m.elapsed()); // NOLINT
+    }
+
+    friend std::ostream& operator<<(std::ostream&                 os,
+                                    const concurrent_accumulator& acc)
+    {
+        const auto t(acc.totals());
+        os << acc._tag << ": "s 
+           << std::to_string(t._elapsed) << " "s << timepoint::unit() << ", "s
+           << std::to_string(t._count) << " calls, "s
+           << std::to_string(t._count ? t._elapsed / t._count : 0) << " "s << timepoint::unit() << "/call"s;
+        return os;
+    }
+
+private:
+
+    // One writer, the owning thread
+    struct alignas(lpt::cpu::cache_line_size) slot_t
+    {
+        std::atomic<std::int64_t> _elapsed{0};
+        std::atomic<std::int64_t> _count{0};
+    };
+
+    slot_t& local()
+    {
+        return lpt::detail::thread_slot<slot_t>(_id, [this] {
+            std::lock_guard<std::mutex> lock(_lock);
+            _slots.push_back(std::make_unique<slot_t>());
+            return _slots.back().get();
+        });
+    }
+
+private:
+
+    const std::string                     _tag;
+    const lpt::detail::object_id          _id;
+    mutable std::mutex                    _lock;    // slot registration and reads
+    std::vector<std::unique_ptr<slot_t>>  _slots;
+
+}; // concurrent_accumulator
+
 }} //namespace lpt::chrono
 
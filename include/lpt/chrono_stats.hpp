@@ -10,8 +10,12 @@
 #pragma once
 
 #include <lpt/chrono.hpp>
+#include <lpt/hdr_histogram.hpp>
+#include <lpt/sample_log.hpp>
 #include <lpt/stats.hpp>
 
+#include <algorithm>
+#include <cstddef>
 #include <type_traits>
 
 namespace lpt::chrono
@@ -24,6 +28,7 @@ namespace lpt::chrono
    lpt::chrono::timepoint::duration_t moveConstructionDuration;
 
    lpt::chrono::dataset statsAsVals(lpt::chrono::timepoint::name());
+   statsAsVals.subtract(lpt::chrono::calibration<>::instance()._median); // short regions: less the cost of measuring
    statsAsVals(moveConstructionDuration);
 
    lpt::chrono::dataset statsAsPcts("% Move/Copy");
@@ -31,32 +36,81 @@ namespace lpt::chrono
 
    std::cout << statsAsVals << "\n" << statsAsPcts;
 
+   // Tail percentiles; percents kept to 0.01
+   lpt::chrono::hdr_dataset tailAsVals(lpt::chrono::timepoint::name());
+   lpt::chrono::hdr_dataset tailAsPcts("% Move/Copy", 0.01);
+
 \endcode
  */
-struct dataset : public lpt::stats::dataset
+template <typename STATS_T>
+struct basic_dataset : public STATS_T
 {  
-    using value_t = lpt::stats::dataset::value_t;
+    using value_t = typename STATS_T::value_t;
     static_assert(std::is_same_v<value_t, lpt::chrono::timepoint::percent_t>, "Both should be double");
 
-    using lpt::stats::dataset::dataset;
+    using STATS_T::STATS_T;
 
     void operator()(const lpt::chrono::timepoint& data)
     {
-        _stats(static_cast<value_t>(data.elapsed().count()));
+        this->_stats(static_cast<value_t>(net(data.elapsed()).count()));
     }
 
     void operator()(const lpt::chrono::timepoint::duration_t& data)
     {
-        _stats(static_cast<value_t>(data.count()));
+        this->_stats(static_cast<value_t>(net(data).count()));
     }
 
-    /// As percents over @param base
+    /// As percents over @param base; skipped, and counted, if base is not above the floor
     void operator()(const lpt::chrono::timepoint::duration_t& data,
                     const lpt::chrono::timepoint::duration_t& base)
     {
-        _stats(lpt::chrono::timepoint::as_percent_of(data, base));
+        const auto netBase(net(base));
+        if (netBase == lpt::chrono::timepoint::duration_t::zero()) {
+            ++_skipped;
+            return;
+        }
+        this->_stats(lpt::chrono::timepoint::as_percent_of(net(data), netBase));
+    }
+
+    /// Percent samples dropped for a zero base
+    std::size_t skipped() const noexcept
+    {
+        return _skipped;
+    }
+
+    /// Subtract @param floor, e.g. calibration<>::instance()._median, from every duration; clamped to 0
+    void subtract(lpt::chrono::timepoint::duration_t floor)
+    {
+        _floor = floor;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const basic_dataset& dt)
+    {
+        os << static_cast<const STATS_T&>(dt);
+        if (dt._floor.count()) {
+            os << "Measurement floor subtracted: " << dt._floor.count() << ' ' << lpt::chrono::timepoint::unit() << '\n';
+        }
+        if (dt._skipped) {
+            os << "Skipped, base not above the floor: " << dt._skipped << '\n';
+        }
+        return os;
+    }
+
+private:
+
+    lpt::chrono::timepoint::duration_t net(lpt::chrono::timepoint::duration_t data) const
+    {
+        return std::max(data - _floor, lpt::chrono::timepoint::duration_t::zero());
     }
+
+    lpt::chrono::timepoint::duration_t _floor{};
+    std::size_t                        _skipped = 0;
 };
 
+using dataset        = basic_dataset<lpt::stats::dataset>;
+using hdr_dataset    = basic_dataset<lpt::stats::hdr_dataset<>>;
+using sample_dataset = basic_dataset<lpt::stats::sample_dataset>;
+using logged_dataset = basic_dataset<lpt::stats::logged_dataset>;
+
 } // namespace lpt::chrono
 
@@ -0,0 +1,420 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  \brief Sharded, thread safe LRU array; C++20
+ *
+ */
+
+#ifndef INCLUDED_concurrent_lru_array_hpp_3f0c7d52_8e4b_4c1a_9d6e_2b7a51e0c9f4
+#define INCLUDED_concurrent_lru_array_hpp_3f0c7d52_8e4b_4c1a_9d6e_2b7a51e0c9f4
+
+#pragma once
+
+#include <lpt/cpu.hpp>
+#include <lpt/lru_array.hpp>
+
+#include <array>
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lpt {
+
+/*
+ * KEYs are hashed to SHARDS independent lru_array segments of N/SHARDS
+ * items, each with its own lock and on its own cache line(s). An
+ * operation takes only the lock of the key's shard.
+ *
+ * Recency is per shard: the evicted item is the least recently used of
+ * its shard, not necessarily of the whole container.
+ *
+ * \code
+ *     lpt::concurrent_lru_array<uint64_t, Session, 4096, 64> cache;
+ *     cache.push(id, session);
+ *     if (auto s = cache.get(id); s) {...}
+ *     Session s = cache.get_or_load(id, [](uint64_t id) { return db.session(id); });
+ * \endcode
+ */
+template <typename                  KEY,
+          typename                  T,
+          std::size_t               N,
+          std::size_t               SHARDS = 16,
+          typename                  LOCK_T = std::mutex,
+          template <std::size_t> class POLICY    = eviction::lru,
+          template <std::size_t> class ADMISSION = admission::always,
+          typename                  COUNTERS  = lru_counters::none
+>
+class concurrent_lru_array
+{
+public:
+
+    static_assert(SHARDS > 0 && N % SHARDS == 0, "N must be a multiple of SHARDS");
+
+    static constexpr std::size_t SHARD_SIZE = N / SHARDS;
+
+    using shard_array_t = lru_array<KEY, T, SHARD_SIZE, POLICY, ADMISSION, COUNTERS>;
+    using lock_t        = LOCK_T;
+    using ttl_t         = typename shard_array_t::ttl_t;
+
+    concurrent_lru_array()  = default;
+    ~concurrent_lru_array() = default;
+
+    /// Each shard gets an equal part of @param maxCost
+    explicit concurrent_lru_array(std::size_t maxCost)
+    {
+        for (auto& s : _shards) {
+            s._data.max_cost(maxCost / SHARDS);
+        }
+    }
+
+    concurrent_lru_array(const concurrent_lru_array&)            = delete;
+    concurrent_lru_array& operator=(const concurrent_lru_array&) = delete;
+    concurrent_lru_array(concurrent_lru_array&&)                 = delete;
+    concurrent_lru_array& operator=(concurrent_lru_array&&)      = delete;
+
+    static constexpr std::size_t max_size() noexcept
+    {
+        return N;
+    }
+
+    /// Not a snapshot: shards are locked one after the other
+    std::size_t size() const
+    {
+        std::size_t n(0);
+        for (const auto& s : _shards) {
+            std::lock_guard<lock_t> lock(s._lock);
+            n += s._data.size();
+        }
+        return n;
+    }
+
+    /// @see lru_array::push
+    bool push(const KEY& key, const T& data, std::size_t cost = 0, ttl_t ttl = ttl_t::zero())
+    {
+        auto& s(shard(key));
+        std::lock_guard<lock_t> lock(s._lock);
+        return s._data.push(key, data, cost, ttl);
+    }
+
+    bool push(const KEY& key, T&& data, std::size_t cost = 0, ttl_t ttl = ttl_t::zero())
+    {
+        auto& s(shard(key));
+        std::lock_guard<lock_t> lock(s._lock);
+        return s._data.push(key, std::move(data), cost, ttl);
+    }
+
+    /// @return a copy of the data for @param key; a hit refreshes recency
+    std::optional<T> get(const KEY& key)
+    {
+        auto& s(shard(key));
+        std::lock_guard<lock_t> lock(s._lock);
+        return s._data.get(key);
+    }
+
+    /// Apply @param func to the data for @param key under the shard lock; a hit refreshes recency
+    template <typename FUNC>
+    bool visit(const KEY& key, FUNC&& func)
+    {
+        auto& s(shard(key));
+        std::lock_guard<lock_t> lock(s._lock);
+        if (T* p = s._data.find(key); p) {
+            std::invoke(std::forward<FUNC>(func), *p);
+            return true;
+        }
+        return false;
+    }
+
+    /*
+     * Single flight: on a miss the first caller runs @param loader(key)
+     * without holding the shard lock; concurrent misses on the same key
+     * wait for that load instead of running their own. Waiters are
+     * parked on a std::atomic wait (a futex on Linux).
+     *
+     * If the loader throws, nothing is cached and every waiter gets the
+     * exception; the next miss tries again.
+     *
+     * @return a copy of the cached or loaded data
+     */
+    template <typename LOADER>
+    T get_or_load(const KEY& key, LOADER&& loader)
+    {
+        auto&            s(shard(key));
+        std::optional<T> hit;
+
+        auto [f, leader] = join(s, key, hit);
+        if ( ! f) {
+            return std::move(*hit);
+        }
+        if (leader) {
+            land(s, key, *f, std::forward<LOADER>(loader));
+        } else {
+            f->wait();
+        }
+        return f->result();
+    }
+
+    /*
+     * co_await-able get_or_load. Shares in-flight loads with get_or_load.
+     * A coroutine that misses first runs the loader inline; later ones are
+     * suspended and resumed, on the loading thread, once the load lands.
+     * Works with any promise type, e.g. the coroframe ones of
+     * lpt/coroutines/corostack.hpp: a parked coroutine keeps its async
+     * stack links and can be walked with lpt::corostack.
+     *
+     * \code
+     *     Async<Session> handle(uint64_t id) {
+     *         Session s = co_await cache.async_get_or_load(id, loadSession);
+     *         ...
+     *     }
+     * \endcode
+     */
+    template <typename LOADER>
+    auto async_get_or_load(const KEY& key, LOADER&& loader)
+    {
+        return load_awaiter<std::decay_t<LOADER>>(*this, key, std::forward<LOADER>(loader));
+    }
+
+    bool contains(const KEY& key) const
+    {
+        const auto& s(shard(key));
+        std::lock_guard<lock_t> lock(s._lock);
+        return s._data.contains(key);
+    }
+
+    bool erase(const KEY& key)
+    {
+        auto& s(shard(key));
+        std::lock_guard<lock_t> lock(s._lock);
+        return s._data.erase(key);
+    }
+
+    /// Sweep @param maxSlots slots of each shard, one shard locked at a time
+    std::size_t expire(std::size_t maxSlots)
+    {
+        std::size_t n(0);
+        for (auto& s : _shards) {
+            std::lock_guard<lock_t> lock(s._lock);
+            n += s._data.expire(maxSlots);
+        }
+        return n;
+    }
+
+    /// Sum over shards; lock free with lru_counters::relaxed
+    lru_counters::snapshot counters() const noexcept
+        requires (std::is_same_v<COUNTERS, lru_counters::relaxed>)
+    {
+        lru_counters::snapshot s;
+        for (const auto& sh : _shards) {
+            s += sh._data.counters();
+        }
+        return s;
+    }
+
+    lru_counters::snapshot counters() const
+    {
+        lru_counters::snapshot s;
+        for (const auto& sh : _shards) {
+            std::lock_guard<lock_t> lock(sh._lock);
+            s += sh._data.counters();
+        }
+        return s;
+    }
+
+    void clear()
+    {
+        for (auto& s : _shards) {
+            std::lock_guard<lock_t> lock(s._lock);
+            s._data.clear();
+        }
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const concurrent_lru_array& a)
+    {
+        for (std::size_t i = 0; i < SHARDS; ++i) {
+            const auto& s(a._shards[i]);
+            std::lock_guard<lock_t> lock(s._lock);
+            os << "Shard " << i << ":\n" << s._data;
+        }
+        return os;
+    }
+
+private:
+
+    // One in-flight load, shared by the loader and its waiters
+    struct flight
+    {
+        enum : std::uint32_t { LOADING, READY, FAILED };
+
+        std::atomic<std::uint32_t>           _state{LOADING};
+        std::optional<T>                     _value;
+        std::exception_ptr                   _error;
+        std::vector<std::coroutine_handle<>> _waiters;  // guarded by the shard lock
+
+        void wait() const noexcept
+        {
+            while (_state.load(std::memory_order_acquire) == LOADING) {
+                _state.wait(LOADING, std::memory_order_acquire);
+            }
+        }
+
+        T result() const
+        {
+            if (_error) {
+                std::rethrow_exception(_error);
+            }
+            return *_value;
+        }
+    };
+
+    using flight_ptr = std::shared_ptr<flight>;
+
+    struct alignas(lpt::cpu::cache_line_size) shard_t
+    {
+        mutable lock_t                        _lock;
+        shard_array_t                         _data;
+        std::unordered_map<KEY, flight_ptr>   _flights;
+    };
+
+    template <typename LOADER>
+    class load_awaiter
+    {
+    public:
+
+        template <typename L>
+        load_awaiter(concurrent_lru_array& cache, const KEY& key, L&& loader)
+            : _cache(cache)
+            , _shard(cache.shard(key))
+            , _key(key)
+            , _loader(std::forward<L>(loader))
+        {}
+
+        bool await_ready()
+        {
+            auto [f, leader] = _cache.join(_shard, _key, _hit);
+            if ( ! f) {
+                return true;
+            }
+            _flight = std::move(f);
+            if (leader) {
+                _cache.land(_shard, _key, *_flight, _loader);
+                return true;
+            }
+            return false;
+        }
+
+        // The load may have landed since await_ready: then do not suspend
+        template <typename PROMISE_T>
+        bool await_suspend(std::coroutine_handle<PROMISE_T> h)
+        {
+            std::lock_guard<lock_t> lock(_shard._lock);
+            if (_flight->_state.load(std::memory_order_relaxed) != flight::LOADING) {
+                return false;
+            }
+            _flight->_waiters.push_back(h);
+            return true;
+        }
+
+        T await_resume()
+        {
+            if (_hit) {
+                return std::move(*_hit);
+            }
+            return _flight->result();
+        }
+
+    private:
+
+        concurrent_lru_array&  _cache;
+        shard_t&               _shard;
+        KEY                    _key;
+        LOADER                 _loader;
+        std::optional<T>       _hit;
+        flight_ptr             _flight;
+
+    }; // load_awaiter
+
+    /*
+     * A hit is copied to @param hit and no flight returned. Otherwise join
+     * the in-flight load of @param key or, as the leader, start one.
+     */
+    std::pair<flight_ptr, bool> join(shard_t& s, const KEY& key, std::optional<T>& hit)
+    {
+        std::lock_guard<lock_t> lock(s._lock);
+        if (const T* p = s._data.find(key); p) {
+            hit.emplace(*p);
+            return {nullptr, false};
+        }
+        auto [it, leader] = s._flights.try_emplace(key);
+        if (leader) {
+            it->second = std::make_shared<flight>();
+        }
+        return {it->second, leader};
+    }
+
+    // Leader: load outside the lock, publish, wake the waiters
+    template <typename LOADER>
+    void land(shard_t& s, const KEY& key, flight& f, LOADER&& loader)
+    {
+        try {
+            f._value.emplace(std::invoke(std::forward<LOADER>(loader), key));
+        } catch (...) {
+            f._error = std::current_exception();
+        }
+
+        std::vector<std::coroutine_handle<>> waiters;
+        {
+            std::lock_guard<lock_t> lock(s._lock);
+            if (f._value) {
+                s._data.push(key, *f._value);
+            }
+            s._flights.erase(key);
+            waiters.swap(f._waiters);
+            f._state.store(f._error ? flight::FAILED : flight::READY, std::memory_order_release);
+        }
+        f._state.notify_all();
+
+        for (auto h : waiters) {
+            h.resume();
+        }
+    }
+
+    // High bits: the shard's own index uses the low bits of the same hash
+    static std::size_t shard_index(const KEY& key)
+    {
+        const std::uint64_t h(detail::mix_hash(std::hash<KEY>{}(key)));
+        return static_cast<std::size_t>(h >> 32) % SHARDS;
+    }
+
+    shard_t& shard(const KEY& key)
+    {
+        return _shards[shard_index(key)];
+    }
+
+    const shard_t& shard(const KEY& key) const
+    {
+        return _shards[shard_index(key)];
+    }
+
+private:
+
+    std::array<shard_t, SHARDS> _shards;
+
+}; // concurrent_lru_array
+
+} //namespace lpt
+
+
+#endif //#define INCLUDED_concurrent_lru_array_hpp_3f0c7d52_8e4b_4c1a_9d6e_2b7a51e0c9f4
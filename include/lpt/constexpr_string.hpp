@@ -190,6 +190,14 @@ public:
     [[nodiscard]] explicit operator std::string() const { return {}; }
 };
 
+/// From a string literal: lpt::make_constexpr_string("abc") is a constexpr_string<3>
+template <std::size_t N>
+[[nodiscard]] constexpr auto make_constexpr_string(const char (&str)[N]) noexcept
+{
+    static_assert(N > 0 && N - 1 <= std::numeric_limits<std::uint16_t>::max());
+    return constexpr_string<static_cast<std::uint16_t>(N - 1)>(std::string_view(str, N - 1));
+}
+
 template <std::uint16_t N>
 [[nodiscard]] constexpr bool operator==(const constexpr_string<N>& lhs, std::string_view rhs) noexcept 
 {
@@ -14,7 +14,11 @@
 #pragma once
 
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <source_location>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -28,6 +32,46 @@ namespace lpt {
 
 namespace cpu {
 
+/*
+ * Padding unit against false sharing. Not std::hardware_destructive_interference_size:
+ * g++ warns it is not ABI stable (-Winterference-size).
+ */
+inline constexpr std::size_t cache_line_size = 64;
+
+/*
+ * Spin loop hint: let the sibling hyperthread run, save power.
+ */
+inline void relax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+/*
+ * Number of relax() that last about as long as a futex sleep/wake
+ * round trip (~2 us): past that, parking is cheaper than spinning.
+ * Measured once. 0 on a single CPU: the owner cannot run while we spin.
+ */
+inline unsigned spin_budget() noexcept
+{
+    static const unsigned budget = []() -> unsigned {
+        if (std::thread::hardware_concurrency() < 2) {
+            return 0;
+        }
+        constexpr unsigned probes = 4096;
+        const auto start(std::chrono::steady_clock::now());
+        for (unsigned i = 0; i < probes; ++i) {
+            relax();
+        }
+        const auto ns(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        return static_cast<unsigned>(std::clamp<long long>(2000LL * probes / std::max<long long>(ns, 1), 64, 64*1024));
+    }();
+    return budget;
+}
+
 namespace impl {
 
 template <typename T, std::size_t N> struct to_tuple {};
@@ -0,0 +1,595 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  \brief Eviction policies for lru_array; C++20
+ *
+ */
+
+#ifndef INCLUDED_eviction_hpp_9b1e4f6a_27c3_4d85_a0f2_6c8d13e5b7a9
+#define INCLUDED_eviction_hpp_9b1e4f6a_27c3_4d85_a0f2_6c8d13e5b7a9
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+namespace lpt {
+
+namespace detail {
+
+using slot_t = std::uint32_t;                                  // index into the slots array
+inline constexpr slot_t npos = std::numeric_limits<slot_t>::max();
+
+// std::hash is the identity for integrals; spread the bits (murmur3 fmix64)
+inline constexpr std::uint64_t mix_hash(std::uint64_t h) noexcept
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/*
+ * Doubly linked lists of slot indices. Several lists can share the
+ * links as long as a slot is in at most one of them.
+ * Front: most recently inserted; back: next to go.
+ */
+template <std::size_t N>
+class slot_links
+{
+public:
+
+    struct list
+    {
+        slot_t       _front = npos;
+        slot_t       _back  = npos;
+        std::size_t  _size  = 0;
+
+        bool empty() const noexcept { return _size == 0; }
+    };
+
+    slot_t next(slot_t idx) const noexcept { return _links[idx]._next; } // towards the back
+    slot_t prev(slot_t idx) const noexcept { return _links[idx]._prev; } // towards the front
+
+    void push_front(list& l, slot_t idx) noexcept
+    {
+        auto& n(_links[idx]);
+        n._prev = npos;
+        n._next = l._front;
+        if (l._front != npos) {
+            _links[l._front]._prev = idx;
+        } else {
+            l._back = idx;
+        }
+        l._front = idx;
+        ++l._size;
+    }
+
+    void unlink(list& l, slot_t idx) noexcept
+    {
+        auto& n(_links[idx]);
+        if (n._prev != npos) {
+            _links[n._prev]._next = n._next;
+        } else {
+            l._front = n._next;
+        }
+        if (n._next != npos) {
+            _links[n._next]._prev = n._prev;
+        } else {
+            l._back = n._prev;
+        }
+        n._prev = n._next = npos;
+        assert(l._size > 0);
+        --l._size;
+    }
+
+    void move_to_front(list& from, list& to, slot_t idx) noexcept
+    {
+        unlink(from, idx);
+        push_front(to, idx);
+    }
+
+    /// The slot nearest the back for which @param skip is false, or npos
+    template <typename SKIP>
+    slot_t last(const list& l, SKIP&& skip) const
+    {
+        slot_t idx(l._back);
+        while (idx != npos && skip(idx)) {
+            idx = _links[idx]._prev;
+        }
+        return idx;
+    }
+
+    /// Back to front: eviction order
+    template <typename FUNC>
+    void for_each(const list& l, FUNC&& func) const
+    {
+        for (slot_t idx = l._back; idx != npos; idx = _links[idx]._prev) {
+            func(idx);
+        }
+    }
+
+private:
+
+    struct link
+    {
+        slot_t _prev = npos;
+        slot_t _next = npos;
+    };
+
+    std::array<link, N> _links{};
+
+}; // slot_links
+
+/*
+ * Hashes of recently evicted keys, FIFO bounded to N. Approximate: a
+ * hash removed early and pushed again keeps its first FIFO position.
+ */
+template <std::size_t N>
+class ghost_fifo
+{
+public:
+
+    static constexpr std::size_t CAPACITY = std::bit_ceil(std::max<std::size_t>(2*N, 2));
+    static constexpr std::size_t MASK     = CAPACITY - 1;
+
+    bool contains(std::uint64_t hash) const noexcept
+    {
+        return position(tag(hash)) != CAPACITY;
+    }
+
+    void push(std::uint64_t hash) noexcept
+    {
+        const auto t(tag(hash));
+        if (position(t) != CAPACITY) {
+            return;
+        }
+        if (_size == N) {
+            remove(_fifo[_head]);
+            _head = (_head + 1) % N;
+            --_size;
+        }
+        _fifo[(_head + _size) % N] = t;
+        ++_size;
+
+        std::size_t pos = t & MASK;
+        while (_table[pos] != 0) {
+            pos = (pos + 1) & MASK;
+        }
+        _table[pos] = t;
+    }
+
+    /// Forget @param hash; its FIFO entry is dropped lazily
+    void erase(std::uint64_t hash) noexcept
+    {
+        remove(tag(hash));
+    }
+
+private:
+
+    static constexpr std::uint64_t tag(std::uint64_t hash) noexcept { return hash | 1; } // 0: empty
+
+    std::size_t position(std::uint64_t t) const noexcept
+    {
+        for (std::size_t pos = t & MASK; _table[pos] != 0; pos = (pos + 1) & MASK) {
+            if (_table[pos] == t) {
+                return pos;
+            }
+        }
+        return CAPACITY;
+    }
+
+    void remove(std::uint64_t t) noexcept
+    {
+        std::size_t pos(position(t));
+        if (pos == CAPACITY) {
+            return;
+        }
+        for (std::size_t next = (pos + 1) & MASK; _table[next] != 0; next = (next + 1) & MASK) {
+            const std::size_t home = _table[next] & MASK;
+            if (((next - home) & MASK) >= ((next - pos) & MASK)) {
+                _table[pos] = _table[next];
+                pos         = next;
+            }
+        }
+        _table[pos] = 0;
+    }
+
+    std::array<std::uint64_t, N>        _fifo{};
+    std::array<std::uint64_t, CAPACITY> _table{};
+    std::size_t                         _head = 0;
+    std::size_t                         _size = 0;
+
+}; // ghost_fifo
+
+} // namespace detail
+
+
+/*
+ * Eviction policies: bookkeeping over the N slots of an lru_array.
+ *
+ *     void   on_insert(slot_t, std::uint64_t keyHash);
+ *     void   on_hit(slot_t);
+ *     void   on_erase(slot_t);            // explicit removal
+ *     slot_t victim();                    // container full; stable until the next call
+ *     slot_t victim(skip);                // same, passing over the slots for which
+ *                                         // skip(slot_t) is true; one must be left
+ *     void   on_evict(slot_t victim);
+ *     void   for_each(func) const;        // used slots, roughly in eviction order
+ *
+ * All state lives in fixed arrays indexed by slot.
+ */
+namespace eviction {
+
+using detail::slot_t;
+using detail::npos;
+
+/*
+ * Strict LRU: a hit moves the slot to the front of the list.
+ */
+template <std::size_t N>
+class lru
+{
+public:
+
+    void on_insert(slot_t idx, std::uint64_t /*hash*/) noexcept { _links.push_front(_list, idx); }
+    void on_hit(slot_t idx)   noexcept { _links.move_to_front(_list, _list, idx); }
+    void on_erase(slot_t idx) noexcept { _links.unlink(_list, idx); }
+    void on_evict(slot_t idx) noexcept { _links.unlink(_list, idx); }
+
+    slot_t victim() const noexcept
+    {
+        assert( ! _list.empty());
+        return _list._back;
+    }
+
+    template <typename SKIP>
+    slot_t victim(SKIP&& skip) const
+    {
+        const slot_t idx(_links.last(_list, skip));
+        assert(idx != npos);
+        return idx;
+    }
+
+    template <typename FUNC>
+    void for_each(FUNC&& func) const { _links.for_each(_list, func); }
+
+private:
+
+    using links_t = detail::slot_links<N>;
+
+    links_t                   _links;
+    typename links_t::list    _list;
+
+}; // lru
+
+/*
+ * CLOCK: a hit sets a reference bit; the hand sweeps the slots clearing
+ * bits until it finds one not referenced.
+ */
+template <std::size_t N>
+class clock
+{
+public:
+
+    void on_insert(slot_t idx, std::uint64_t /*hash*/) noexcept { _state[idx] = USED; }
+    void on_hit(slot_t idx)   noexcept { _state[idx] = USED | REFERENCED; }
+    void on_erase(slot_t idx) noexcept { _state[idx] = FREE; }
+
+    void on_evict(slot_t idx) noexcept
+    {
+        _state[idx] = FREE;
+        _hand       = (idx + 1) % N;
+    }
+
+    slot_t victim() noexcept
+    {
+        return victim([](slot_t) { return false; });
+    }
+
+    // Skipped slots keep their reference bit
+    template <typename SKIP>
+    slot_t victim(SKIP&& skip)
+    {
+        for (std::size_t i = 0; i < 2*N; ++i, _hand = (_hand + 1) % N) {
+            auto& s(_state[_hand]);
+            if ( ! (s & USED) || skip(_hand)) {
+                continue;
+            }
+            if (s == USED) {
+                return _hand;
+            }
+            s &= ~REFERENCED;
+        }
+        assert(false && "No used slot");
+        return npos;
+    }
+
+    template <typename FUNC>
+    void for_each(FUNC&& func) const
+    {
+        for (std::size_t i = 0; i < N; ++i) {
+            const slot_t idx((_hand + i) % N);
+            if (_state[idx] & USED) {
+                func(idx);
+            }
+        }
+    }
+
+private:
+
+    static constexpr std::uint8_t FREE       = 0;
+    static constexpr std::uint8_t USED       = 1;
+    static constexpr std::uint8_t REFERENCED = 2;
+
+    std::array<std::uint8_t, N> _state{};
+    slot_t                      _hand = 0;
+
+}; // clock
+
+/*
+ * SIEVE (Zhang et al., NSDI'24): a FIFO with a visited bit. The hand
+ * moves from the oldest towards the newest, sparing visited slots; the
+ * survivors keep their position.
+ */
+template <std::size_t N>
+class sieve
+{
+public:
+
+    void on_insert(slot_t idx, std::uint64_t /*hash*/) noexcept
+    {
+        _visited[idx] = false;
+        _links.push_front(_list, idx);
+    }
+
+    void on_hit(slot_t idx) noexcept { _visited[idx] = true; }
+
+    void on_erase(slot_t idx) noexcept
+    {
+        if (idx == _hand) {
+            _hand = _links.prev(idx);
+        }
+        _links.unlink(_list, idx);
+    }
+
+    void on_evict(slot_t idx) noexcept { on_erase(idx); }
+
+    slot_t victim() noexcept
+    {
+        return victim([](slot_t) { return false; });
+    }
+
+    // Skipped slots keep their visited bit
+    template <typename SKIP>
+    slot_t victim(SKIP&& skip)
+    {
+        assert( ! _list.empty());
+        slot_t idx(_hand != npos ? _hand : _list._back);
+        while (skip(idx) || _visited[idx]) {
+            if ( ! skip(idx)) {
+                _visited[idx] = false;
+            }
+            idx = _links.prev(idx);
+            if (idx == npos) {
+                idx = _list._back;
+            }
+        }
+        _hand = idx;
+        return idx;
+    }
+
+    template <typename FUNC>
+    void for_each(FUNC&& func) const { _links.for_each(_list, func); }
+
+private:
+
+    using links_t = detail::slot_links<N>;
+
+    links_t                   _links;
+    typename links_t::list    _list;
+    std::array<bool, N>       _visited{};
+    slot_t                    _hand = npos;
+
+}; // sieve
+
+/*
+ * 2Q (Johnson & Shasha, VLDB'94), full version: new keys enter the A1in
+ * FIFO; keys evicted from A1in are remembered in the A1out ghost queue
+ * and, if seen again, go straight to the Am LRU. A scan flows through
+ * A1in without touching Am.
+ */
+template <std::size_t N>
+class two_q
+{
+public:
+
+    static constexpr std::size_t KIN  = std::max<std::size_t>(N/4, 1);
+    static constexpr std::size_t KOUT = std::max<std::size_t>(N/2, 1);
+
+    void on_insert(slot_t idx, std::uint64_t hash) noexcept
+    {
+        _hash[idx] = hash;
+        if (_a1out.contains(hash)) {
+            _a1out.erase(hash);
+            _inAm[idx] = true;
+            _links.push_front(_am, idx);
+        } else {
+            _inAm[idx] = false;
+            _links.push_front(_a1in, idx);
+        }
+    }
+
+    void on_hit(slot_t idx) noexcept
+    {
+        if (_inAm[idx]) {
+            _links.move_to_front(_am, _am, idx);
+        }
+    }
+
+    void on_erase(slot_t idx) noexcept { _links.unlink(list(idx), idx); }
+
+    void on_evict(slot_t idx) noexcept
+    {
+        if ( ! _inAm[idx]) {
+            _a1out.push(_hash[idx]);
+        }
+        _links.unlink(list(idx), idx);
+    }
+
+    slot_t victim() const noexcept
+    {
+        if (_a1in._size > KIN || _am.empty()) {
+            assert( ! _a1in.empty());
+            return _a1in._back;
+        }
+        return _am._back;
+    }
+
+    template <typename SKIP>
+    slot_t victim(SKIP&& skip) const
+    {
+        const slot_t in(_links.last(_a1in, skip));
+        const slot_t am(_links.last(_am, skip));
+        if (in != npos && (_a1in._size > KIN || am == npos)) {
+            return in;
+        }
+        assert(am != npos);
+        return am;
+    }
+
+    template <typename FUNC>
+    void for_each(FUNC&& func) const
+    {
+        _links.for_each(_a1in, func);
+        _links.for_each(_am, func);
+    }
+
+private:
+
+    using links_t = detail::slot_links<N>;
+
+    typename links_t::list& list(slot_t idx) noexcept { return _inAm[idx] ? _am : _a1in; }
+
+    links_t                       _links;
+    typename links_t::list        _a1in;
+    typename links_t::list        _am;
+    std::array<std::uint64_t, N>  _hash{};
+    std::array<bool, N>           _inAm{};
+    detail::ghost_fifo<KOUT>      _a1out;
+
+}; // two_q
+
+/*
+ * S3-FIFO (Yang et al., SOSP'23): a small FIFO (10%) filters one-hit
+ * wonders, a main FIFO with 2-bit frequencies keeps the rest, and a
+ * ghost FIFO sends recently evicted keys straight to main. Hits only
+ * bump a counter.
+ */
+template <std::size_t N>
+class s3fifo
+{
+public:
+
+    static constexpr std::size_t SMALL   = std::max<std::size_t>(N/10, 1);
+    static constexpr std::uint8_t MAXFREQ = 3;
+
+    void on_insert(slot_t idx, std::uint64_t hash) noexcept
+    {
+        _hash[idx] = hash;
+        _freq[idx] = 0;
+        if (_ghost.contains(hash)) {
+            _ghost.erase(hash);
+            _inMain[idx] = true;
+            _links.push_front(_main, idx);
+        } else {
+            _inMain[idx] = false;
+            _links.push_front(_small, idx);
+        }
+    }
+
+    void on_hit(slot_t idx) noexcept
+    {
+        _freq[idx] = std::min<std::uint8_t>(_freq[idx] + 1, MAXFREQ);
+    }
+
+    void on_erase(slot_t idx) noexcept { _links.unlink(list(idx), idx); }
+
+    void on_evict(slot_t idx) noexcept
+    {
+        if ( ! _inMain[idx]) {
+            _ghost.push(_hash[idx]);
+        }
+        _links.unlink(list(idx), idx);
+    }
+
+    slot_t victim() noexcept
+    {
+        return victim([](slot_t) { return false; });
+    }
+
+    // Skipped slots keep their queue, position and frequency
+    template <typename SKIP>
+    slot_t victim(SKIP&& skip)
+    {
+        for (;;) {
+            const slot_t s(_links.last(_small, skip));
+            const slot_t m(_links.last(_main, skip));
+
+            if (s != npos && (_small._size >= SMALL || m == npos)) {
+                if (_freq[s] == 0) {
+                    return s;
+                }
+                _freq[s]   = 0;
+                _inMain[s] = true;
+                _links.move_to_front(_small, _main, s);
+                continue;
+            }
+
+            assert(m != npos);
+            if (_freq[m] == 0) {
+                return m;
+            }
+            --_freq[m];
+            _links.move_to_front(_main, _main, m);
+        }
+    }
+
+    template <typename FUNC>
+    void for_each(FUNC&& func) const
+    {
+        _links.for_each(_small, func);
+        _links.for_each(_main, func);
+    }
+
+private:
+
+    using links_t = detail::slot_links<N>;
+
+    typename links_t::list& list(slot_t idx) noexcept { return _inMain[idx] ? _main : _small; }
+
+    links_t                       _links;
+    typename links_t::list        _small;
+    typename links_t::list        _main;
+    std::array<std::uint64_t, N>  _hash{};
+    std::array<std::uint8_t, N>   _freq{};
+    std::array<bool, N>           _inMain{};
+    detail::ghost_fifo<N>         _ghost;
+
+}; // s3fifo
+
+} // namespace eviction
+
+} //namespace lpt
+
+
+#endif //#define INCLUDED_eviction_hpp_9b1e4f6a_27c3_4d85_a0f2_6c8d13e5b7a9
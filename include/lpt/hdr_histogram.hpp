@@ -0,0 +1,432 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under LGPL 3.0 or later.
+ *
+ *  \brief Log-linear (HdrHistogram-like) histogram and stats container; C++20
+ *
+ */
+
+#ifndef INCLUDED_hdr_histogram_hpp_7d2e91b4_c053_4a8f_9e16_b8f40a3d5c27
+#define INCLUDED_hdr_histogram_hpp_7d2e91b4_c053_4a8f_9e16_b8f40a3d5c27
+
+#pragma once
+
+#include <lpt/varint.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace lpt::stats
+{
+
+/*
+ * Counts of unsigned integers in buckets that are exact below
+ * 2^(PRECISION_BITS+1) then split each power of 2 in 2^PRECISION_BITS:
+ * a bucket spans less than 1/2^PRECISION_BITS of its values (7: < 0.8%).
+ *
+ * Recording is O(1), a bit_width and a shift. Memory is fixed: the
+ * (65 - PRECISION_BITS) * 2^PRECISION_BITS counters are allocated by the
+ * first record(). min and max are exact; percentiles are exact to the
+ * bucket. Histograms of different threads merge by adding counters.
+ *
+ * \code
+ *     lpt::stats::hdr_histogram<> h;
+ *     h.record(ns);
+ *     std::cout << h.percentile(99.9);
+ *     h.write(file);
+ * \endcode
+ */
+template <unsigned PRECISION_BITS = 7>
+class hdr_histogram
+{
+public:
+
+    static_assert(PRECISION_BITS >= 1 && PRECISION_BITS <= 20);
+
+    static constexpr std::size_t SUB_BUCKETS = std::size_t(1) << PRECISION_BITS;
+    static constexpr std::size_t BUCKETS     = (65 - PRECISION_BITS) * SUB_BUCKETS;
+
+    hdr_histogram()                                = default;
+    ~hdr_histogram()                               = default;
+    hdr_histogram(const hdr_histogram&)            = default;
+    hdr_histogram& operator=(const hdr_histogram&) = default;
+    hdr_histogram(hdr_histogram&&)                 = default;
+    hdr_histogram& operator=(hdr_histogram&&)      = default;
+
+    static constexpr std::size_t bucket(std::uint64_t value) noexcept
+    {
+        const unsigned width(std::bit_width(value));
+        if (width <= PRECISION_BITS + 1) {
+            return static_cast<std::size_t>(value);
+        }
+        const unsigned shift(width - PRECISION_BITS - 1);
+        return (std::size_t(shift) << PRECISION_BITS) + static_cast<std::size_t>(value >> shift);
+    }
+
+    /// Smallest value of bucket @param idx
+    static constexpr std::uint64_t lowest(std::size_t idx) noexcept
+    {
+        if (idx < 2 * SUB_BUCKETS) {
+            return idx;
+        }
+        const unsigned shift(static_cast<unsigned>(idx / SUB_BUCKETS - 1));
+        return static_cast<std::uint64_t>(idx - shift * SUB_BUCKETS) << shift;
+    }
+
+    /// Largest value of bucket @param idx
+    static constexpr std::uint64_t highest(std::size_t idx) noexcept
+    {
+        return idx + 1 < BUCKETS ? lowest(idx + 1) - 1 : std::numeric_limits<std::uint64_t>::max();
+    }
+
+    void record(std::uint64_t value, std::uint64_t n = 1)
+    {
+        if (n == 0) {
+            return;
+        }
+        if (_counts.empty()) {
+            _counts.resize(BUCKETS);
+        }
+        _counts[bucket(value)] += n;
+        _count += n;
+        _min    = std::min(_min, value);
+        _max    = std::max(_max, value);
+    }
+
+    hdr_histogram& operator+=(const hdr_histogram& other)
+    {
+        if (other._count == 0) {
+            return *this;
+        }
+        if (_counts.empty()) {
+            _counts.resize(BUCKETS);
+        }
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            _counts[i] += other._counts[i];
+        }
+        _count += other._count;
+        _min    = std::min(_min, other._min);
+        _max    = std::max(_max, other._max);
+        return *this;
+    }
+
+    void clear() noexcept
+    {
+        std::fill(_counts.begin(), _counts.end(), 0);
+        _count = 0;
+        _min   = std::numeric_limits<std::uint64_t>::max();
+        _max   = 0;
+    }
+
+    std::uint64_t count() const noexcept { return _count; }
+    std::uint64_t min()   const noexcept { return _count ? _min : 0; }
+    std::uint64_t max()   const noexcept { return _max; }
+
+    std::uint64_t count(std::size_t idx) const noexcept
+    {
+        return _counts.empty() ? 0 : _counts[idx];
+    }
+
+    /// Bucket of the @param rank th smallest value, 1-based; @pre 0 < rank <= count()
+    std::size_t bucket_at_rank(std::uint64_t rank) const noexcept
+    {
+        std::uint64_t seen(0);
+        for (std::size_t i = bucket(min()); i < BUCKETS; ++i) {
+            seen += _counts[i];
+            if (seen >= rank) {
+                return i;
+            }
+        }
+        return bucket(max());
+    }
+
+    /// Largest value of the bucket holding @param pct percent of the values, within [min, max]; 0 if empty
+    std::uint64_t percentile(double pct) const noexcept
+    {
+        if (_count == 0) {
+            return 0;
+        }
+        return std::clamp(highest(bucket_at_rank(rank(pct, _count))), min(), max());
+    }
+
+    /// 1-based rank of the @param pct percentile of @param n values
+    static std::uint64_t rank(double pct, std::uint64_t n) noexcept
+    {
+        const double r(std::ceil(std::clamp(pct, 0.0, 100.0) / 100 * static_cast<double>(n)));
+        return std::clamp<std::uint64_t>(static_cast<std::uint64_t>(r), 1, n);
+    }
+
+    /*
+     * Binary: magic, PRECISION_BITS, then varints: min, max, the number of
+     * non empty buckets and, for each, its distance to the previous one
+     * and its count. A few bytes per distinct bucket.
+     */
+    void write(std::ostream& os) const
+    {
+        os.write(MAGIC, sizeof(MAGIC));
+        os.put(static_cast<char>(PRECISION_BITS));
+        lpt::varint::put(os, min());
+        lpt::varint::put(os, max());
+        const auto used(_counts.empty() ? 0 : BUCKETS - std::count(_counts.begin(), _counts.end(), 0));
+        lpt::varint::put(os, static_cast<std::uint64_t>(used));
+        std::size_t prev(0);
+        for (std::size_t i = 0; i < _counts.size(); ++i) {
+            if (_counts[i]) {
+                lpt::varint::put(os, i - prev);
+                lpt::varint::put(os, _counts[i]);
+                prev = i;
+            }
+        }
+    }
+
+    /// Throws std::runtime_error on a malformed stream or another PRECISION_BITS
+    static hdr_histogram read(std::istream& is)
+    {
+        char magic[sizeof(MAGIC)];
+        if ( ! is.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("hdr_histogram: bad magic");
+        }
+        if (is.get() != static_cast<int>(PRECISION_BITS)) {
+            throw std::runtime_error("hdr_histogram: precision mismatch");
+        }
+
+        hdr_histogram h;
+        const std::uint64_t minValue(lpt::varint::get(is));
+        const std::uint64_t maxValue(lpt::varint::get(is));
+        const std::uint64_t used(lpt::varint::get(is));
+        std::size_t         idx(0);
+        for (std::uint64_t i = 0; i < used; ++i) {
+            idx += lpt::varint::get(is);
+            const std::uint64_t n(lpt::varint::get(is));
+            if (idx >= BUCKETS) {
+                throw std::runtime_error("hdr_histogram: bad bucket");
+            }
+            h.record(lowest(idx), n);
+        }
+        if (h._count) {
+            h._min = minValue;
+            h._max = maxValue;
+        }
+        return h;
+    }
+
+private:
+
+    static constexpr char MAGIC[4] = {'L', 'H', 'D', 'R'};
+
+    std::vector<std::uint64_t> _counts;     // BUCKETS, or empty until the first record()
+    std::uint64_t              _count = 0;
+    std::uint64_t              _min   = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t              _max   = 0;
+
+}; // hdr_histogram
+
+
+/*
+ * Drop-in for a boost accumulator_set of doubles: values are rounded to
+ * multiples of @param unit (1 for nanoseconds, 0.01 for percents) and
+ * counted, by magnitude, in one histogram per sign. min, max, mean and
+ * variance are computed exactly from the values.
+ */
+template <unsigned PRECISION_BITS = 7>
+class hdr_accumulator
+{
+public:
+
+    using value_t     = double;
+    using histogram_t = hdr_histogram<PRECISION_BITS>;
+
+    explicit hdr_accumulator(value_t unit = 1) : _unit(unit) {}
+
+    ~hdr_accumulator()                                 = default;
+    hdr_accumulator(const hdr_accumulator&)            = default;
+    hdr_accumulator& operator=(const hdr_accumulator&) = default;
+    hdr_accumulator(hdr_accumulator&&)                 = default;
+    hdr_accumulator& operator=(hdr_accumulator&&)      = default;
+
+    void operator()(value_t data)
+    {
+        const auto magnitude(static_cast<std::uint64_t>(std::llround(std::fabs(data) / _unit)));
+        (data < 0 ? _negative : _positive).record(magnitude);
+
+        // Welford
+        ++_count;
+        const value_t delta(data - _mean);
+        _mean += delta / _count;
+        _m2   += delta * (data - _mean);
+        _min   = std::min(_min, data);
+        _max   = std::max(_max, data);
+    }
+
+    /// Same unit and PRECISION_BITS; e.g. per thread accumulators
+    hdr_accumulator& operator+=(const hdr_accumulator& other)
+    {
+        if (other._count == 0) {
+            return *this;
+        }
+        // Chan et al.
+        const value_t n(static_cast<value_t>(_count + other._count));
+        const value_t delta(other._mean - _mean);
+        _m2   += other._m2 + delta * delta * _count * other._count / n;
+        _mean += delta * other._count / n;
+        _count += other._count;
+        _min    = std::min(_min, other._min);
+        _max    = std::max(_max, other._max);
+
+        _positive += other._positive;
+        _negative += other._negative;
+        return *this;
+    }
+
+    /// Keeps the unit and the histograms' memory
+    void clear() noexcept
+    {
+        _positive.clear();
+        _negative.clear();
+        _count = 0;
+        _mean  = 0;
+        _m2    = 0;
+        _min   = std::numeric_limits<value_t>::max();
+        _max   = std::numeric_limits<value_t>::lowest();
+    }
+
+    std::uint64_t count() const noexcept { return _count; }
+    value_t       min()   const noexcept { return _count ? _min : 0; }
+    value_t       max()   const noexcept { return _count ? _max : 0; }
+    value_t       mean()  const noexcept { return _mean; }
+
+    /// Sample variance
+    value_t variance() const noexcept
+    {
+        return _count > 1 ? _m2 / (_count - 1) : 0;
+    }
+
+    /// Bucket upper bound of the @param pct percentile, within [min, max]; 0 if empty
+    value_t percentile(double pct) const noexcept
+    {
+        if (_count == 0) {
+            return 0;
+        }
+        const std::uint64_t r(histogram_t::rank(pct, _count));
+        const std::uint64_t negatives(_negative.count());
+        value_t             value;
+        if (r <= negatives) {
+            // Largest magnitudes first
+            const std::uint64_t magnitude(histogram_t::lowest(_negative.bucket_at_rank(negatives - r + 1)));
+            value = -static_cast<value_t>(magnitude) * _unit;
+        } else {
+            const std::uint64_t magnitude(histogram_t::highest(_positive.bucket_at_rank(r - negatives)));
+            value = static_cast<value_t>(magnitude) * _unit;
+        }
+        return std::clamp(value, _min, _max);
+    }
+
+    /// (name, value) pairs for a reporter, @see lpt::stats::interval_dataset
+    template <typename FIELDS>
+    void fields(FIELDS& out, const std::string& prefix = {}) const
+    {
+        out.emplace_back(prefix + "count",  static_cast<value_t>(count()));
+        out.emplace_back(prefix + "min",    min());
+        out.emplace_back(prefix + "max",    max());
+        out.emplace_back(prefix + "mean",   mean());
+        out.emplace_back(prefix + "stddev", std::sqrt(variance()));
+        out.emplace_back(prefix + "p50",    percentile(50));
+        out.emplace_back(prefix + "p90",    percentile(90));
+        out.emplace_back(prefix + "p99",    percentile(99));
+        out.emplace_back(prefix + "p99.9",  percentile(99.9));
+    }
+
+    value_t            unit()     const noexcept { return _unit; }
+    const histogram_t& positive() const noexcept { return _positive; }
+    const histogram_t& negative() const noexcept { return _negative; }
+
+private:
+
+    value_t       _unit;
+    histogram_t   _positive;
+    histogram_t   _negative;    // magnitudes
+
+    std::uint64_t _count = 0;
+    value_t       _mean  = 0;
+    value_t       _m2    = 0;
+    value_t       _min   = std::numeric_limits<value_t>::max();
+    value_t       _max   = std::numeric_limits<value_t>::lowest();
+
+}; // hdr_accumulator
+
+
+/**
+ * As lpt::stats::dataset, with tail percentiles instead of a P^2 median.
+ *
+\code
+
+   lpt::stats::hdr_dataset<> latencies("Latency ns");
+   lpt::stats::hdr_dataset<> gains("% Move/Copy", 0.01);
+
+\endcode
+ */
+template <unsigned PRECISION_BITS = 7>
+struct hdr_dataset
+{
+    using value_t   = double;
+    using dataset_t = hdr_accumulator<PRECISION_BITS>;
+
+    /// @param unit: resolution of the values, e.g. 0.01 for percents
+    hdr_dataset(const std::string& tag, value_t unit = 1) : _tag(tag), _stats(unit) {}
+
+    hdr_dataset()                              = default;
+    ~hdr_dataset()                             = default;
+    hdr_dataset(const hdr_dataset&)            = default;
+    hdr_dataset& operator=(const hdr_dataset&) = default;
+    hdr_dataset(hdr_dataset&&)                 = default;
+    hdr_dataset& operator=(hdr_dataset&&)      = default;
+
+    void operator()(const value_t& data)
+    {
+        _stats(data);
+    }
+
+    hdr_dataset& operator+=(const hdr_dataset& other)
+    {
+        _stats += other._stats;
+        return *this;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const hdr_dataset& dt)
+    {
+        const auto& stat(dt._stats);
+        os << "Name, samples, min, max, mean, stddev, p50, p90, p99, p99.9, p99.99\n"
+           << dt._tag                     << ", "
+           << stat.count()                << ", "
+           << stat.min()                  << ", "
+           << stat.max()                  << ", "
+           << stat.mean()                 << ", "
+           << std::sqrt(stat.variance())  << ", "
+           << stat.percentile(50)         << ", "
+           << stat.percentile(90)         << ", "
+           << stat.percentile(99)         << ", "
+           << stat.percentile(99.9)       << ", "
+           << stat.percentile(99.99)
+           << '\n';
+
+        return os;
+    }
+
+    const std::string _tag;
+    dataset_t         _stats;
+};
+
+} // namespace lpt::stats
+
+
+#endif //#define INCLUDED_hdr_histogram_hpp_7d2e91b4_c053_4a8f_9e16_b8f40a3d5c27
@@ -0,0 +1,256 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  \brief Indexed d-ary heap with update/erase by handle; C++20
+ *
+ */
+
+#ifndef INCLUDED_indexed_heap_hpp_8b1e4f27_3c6a_4d95_a0f2_7e5d19c64b38
+#define INCLUDED_indexed_heap_hpp_8b1e4f27_3c6a_4d95_a0f2_7e5d19c64b38
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace lpt {
+
+/*
+ * Priority queue in one contiguous vector: top() is the smallest item
+ * according to COMPARE_T, as for ordered_set.
+ *
+ * push() returns a handle that stays valid until the item is popped or
+ * erased; update() (decrease or increase key) and erase() by handle are
+ * O(log n) through a handle->position map. Unlike ordered_set, equal
+ * items are not merged: use update() to re-prioritize an item.
+ *
+ * ARITY 4: a node's children are contiguous and the tree is half as deep
+ * as a binary heap, so sift-down touches fewer cache lines.
+ *
+ * \code
+ *     lpt::indexed_heap<Deadline> timers;
+ *     auto h = timers.push(d);
+ *     timers.update(h, later);
+ *     while ( ! timers.empty() && timers.top() <= now) timers.pop();
+ * \endcode
+ */
+template <typename    T,
+          typename    COMPARE_T = std::less<T>,
+          std::size_t ARITY     = 4
+>
+class indexed_heap
+{
+public:
+
+    static_assert(ARITY >= 2, "Not a tree");
+
+    using handle_t = std::uint32_t;
+
+    static constexpr handle_t npos = std::numeric_limits<handle_t>::max();
+
+    indexed_heap()  = default;
+    ~indexed_heap() = default;
+
+    explicit indexed_heap(const COMPARE_T& cmp) : _cmp(cmp) {}
+
+    indexed_heap(const indexed_heap&)            = default;
+    indexed_heap& operator=(const indexed_heap&) = default;
+    indexed_heap(indexed_heap&&)                 = default;
+    indexed_heap& operator=(indexed_heap&&)      = default;
+
+    std::size_t size() const noexcept  { return _heap.size(); }
+    bool        empty() const noexcept { return _heap.empty(); }
+
+    void reserve(std::size_t n)
+    {
+        _heap.reserve(n);
+        _pos.reserve(n);
+    }
+
+    handle_t push(const T& data) { return emplace(data); }
+    handle_t push(T&& data)      { return emplace(std::move(data)); }
+
+    template <typename... ARGS>
+    handle_t emplace(ARGS&&... args)
+    {
+        handle_t h;
+        if (_freeHandle != npos) {
+            h           = _freeHandle;
+            _freeHandle = _pos[h];
+        } else {
+            assert(_pos.size() < npos);
+            h = static_cast<handle_t>(_pos.size());
+            _pos.push_back(npos);
+        }
+
+        _heap.push_back({T(std::forward<ARGS>(args)...), h});
+        sift_up(_heap.size() - 1);
+        return h;
+    }
+
+    const T& top() const
+    {
+        assert( ! empty());
+        return _heap.front()._data;
+    }
+
+    handle_t top_handle() const
+    {
+        assert( ! empty());
+        return _heap.front()._handle;
+    }
+
+    void pop()
+    {
+        assert( ! empty());
+        remove_at(0);
+    }
+
+    /// @return true if @param h was returned by push and is not yet popped or erased
+    bool contains(handle_t h) const noexcept
+    {
+        return h < _pos.size() && _pos[h] < _heap.size() && _heap[_pos[h]]._handle == h;
+    }
+
+    const T& operator[](handle_t h) const
+    {
+        assert(contains(h));
+        return _heap[_pos[h]]._data;
+    }
+
+    /// Re-prioritize item @param h
+    void update(handle_t h, const T& data)
+    {
+        assert(contains(h));
+        const std::size_t pos(_pos[h]);
+        _heap[pos]._data = data;
+        sift(pos);
+    }
+
+    void update(handle_t h, T&& data)
+    {
+        assert(contains(h));
+        const std::size_t pos(_pos[h]);
+        _heap[pos]._data = std::move(data);
+        sift(pos);
+    }
+
+    void erase(handle_t h)
+    {
+        assert(contains(h));
+        remove_at(_pos[h]);
+    }
+
+    void clear() noexcept
+    {
+        _heap.clear();
+        _pos.clear();
+        _freeHandle = npos;
+    }
+
+private:
+
+    struct node
+    {
+        T         _data;
+        handle_t  _handle;
+    };
+
+    static constexpr std::size_t parent(std::size_t pos) noexcept      { return (pos - 1) / ARITY; }
+    static constexpr std::size_t first_child(std::size_t pos) noexcept { return ARITY * pos + 1; }
+
+    void place(std::size_t pos, node&& n) noexcept
+    {
+        _pos[n._handle] = static_cast<handle_t>(pos);
+        _heap[pos]      = std::move(n);
+    }
+
+    // Move the hole up, not the item: one move per level instead of a swap
+    void sift_up(std::size_t pos)
+    {
+        node n(std::move(_heap[pos]));
+        while (pos > 0) {
+            const std::size_t p(parent(pos));
+            if ( ! _cmp(n._data, _heap[p]._data)) {
+                break;
+            }
+            place(pos, std::move(_heap[p]));
+            pos = p;
+        }
+        place(pos, std::move(n));
+    }
+
+    void sift_down(std::size_t pos)
+    {
+        const std::size_t count(_heap.size());
+        node n(std::move(_heap[pos]));
+        for (;;) {
+            const std::size_t first(first_child(pos));
+            if (first >= count) {
+                break;
+            }
+            const std::size_t last(std::min(first + ARITY, count));
+            std::size_t       best(first);
+            for (std::size_t c = first + 1; c < last; ++c) {
+                if (_cmp(_heap[c]._data, _heap[best]._data)) {
+                    best = c;
+                }
+            }
+            if ( ! _cmp(_heap[best]._data, n._data)) {
+                break;
+            }
+            place(pos, std::move(_heap[best]));
+            pos = best;
+        }
+        place(pos, std::move(n));
+    }
+
+    void sift(std::size_t pos)
+    {
+        if (pos > 0 && _cmp(_heap[pos]._data, _heap[parent(pos)]._data)) {
+            sift_up(pos);
+        } else {
+            sift_down(pos);
+        }
+    }
+
+    // Fill the hole with the last item; freed handles chain through _pos
+    void remove_at(std::size_t pos)
+    {
+        const handle_t h(_heap[pos]._handle);
+        _pos[h]     = _freeHandle;
+        _freeHandle = h;
+
+        const std::size_t last(_heap.size() - 1);
+        if (pos != last) {
+            _heap[pos]               = std::move(_heap[last]);
+            _pos[_heap[pos]._handle] = static_cast<handle_t>(pos);
+            _heap.pop_back();
+            sift(pos);
+        } else {
+            _heap.pop_back();
+        }
+    }
+
+private:
+
+    std::vector<node>      _heap;
+    std::vector<handle_t>  _pos;                // handle -> heap position, or next free handle
+    handle_t               _freeHandle = npos;
+    [[no_unique_address]] COMPARE_T _cmp{};
+
+}; // indexed_heap
+
+} //namespace lpt
+
+
+#endif //#define INCLUDED_indexed_heap_hpp_8b1e4f27_3c6a_4d95_a0f2_7e5d19c64b38
@@ -18,6 +18,7 @@
 
 #include <cassert>
 #include <string>
+#include <string_view>
 #include <iostream>
 
 
@@ -144,6 +145,24 @@ private:
 
 }; // autoindent_guard
 
+
+/// RFC 4180 CSV field: quoted if it holds a separator, quote or line break; quotes doubled
+inline void csv_quote(std::ostream& os, std::string_view str)
+{
+    if (str.find_first_of(",\"\r\n") == std::string_view::npos) {
+        os << str;
+        return;
+    }
+    os << '"';
+    for (const char ch : str) {
+        if (ch == '"') {
+            os << '"';
+        }
+        os << ch;
+    }
+    os << '"';
+}
+
 } //namespace lpt
 
 
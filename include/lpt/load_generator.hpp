@@ -0,0 +1,215 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under LGPL 3.0 or later.
+ *
+ *  \brief Open loop load generator: response time from the intended start; C++20
+ */
+
+#ifndef INCLUDED_load_generator_hpp_b4e07d19_6a2c_4f85_93d1_0c8e5a7f2b64
+#define INCLUDED_load_generator_hpp_b4e07d19_6a2c_4f85_93d1_0c8e5a7f2b64
+
+#pragma once
+
+#include <lpt/chrono.hpp>
+#include <lpt/hdr_histogram.hpp>
+
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace lpt::chrono
+{
+
+enum class arrivals
+{
+    fixed,      // evenly spaced
+    poisson,    // exponential gaps, same mean rate
+};
+
+struct load_options
+{
+    double                    _rate     = 1000;   // calls per second, all threads
+    unsigned                  _threads  = 1;
+    std::chrono::nanoseconds  _duration = std::chrono::seconds(1);
+    arrivals                  _arrivals = arrivals::fixed;
+    std::uint64_t             _seed     = 1;      // poisson
+};
+
+struct load_report
+{
+    using dataset_t = lpt::stats::hdr_dataset<>;
+
+    double                 _targetRate   = 0;          // calls per second
+    double                 _achievedRate = 0;          // calls / (last completion - start)
+    std::uint64_t          _calls        = 0;
+    timepoint::duration_t  _maxLag{};                  // worst actual - intended start
+    dataset_t              _response{"Response ns"};   // completion - intended start
+    dataset_t              _service{"Service ns"};     // completion - actual start
+
+    friend std::ostream& operator<<(std::ostream& os, const load_report& r)
+    {
+        os << "Target, achieved calls/s, calls, max lag ns\n"
+           << r._targetRate     << ", "
+           << r._achievedRate   << ", "
+           << r._calls          << ", "
+           << r._maxLag.count() << '\n'
+           << r._response
+           << r._service;
+        return os;
+    }
+};
+
+/**
+ * Open loop: each of _threads threads calls at its share of _rate on a
+ * schedule fixed in advance and does not wait for the previous call to be
+ * late. A call that starts behind schedule is charged the wait: the
+ * response time runs from the intended start. Closed loop timings (the
+ * service times) hide the queueing of a stall, i.e. coordinated omission.
+ *
+ * @param call: call() or call(unsigned thread); each thread calls its own.
+ *
+\code
+
+   lpt::chrono::load_generator load({._rate = 20'000, ._threads = 2,
+                                     ._arrivals = lpt::chrono::arrivals::poisson});
+   std::cout << load.run([&](){ service.get(key); });
+
+\endcode
+ */
+class load_generator
+{
+public:
+
+    using clock_t = timepoint::clock_t;
+
+    explicit load_generator(const load_options& opts)
+        : _opts(opts)
+    {
+        if ( ! (_opts._rate > 0) || _opts._threads == 0) {
+            throw std::invalid_argument("load_generator: rate and threads must be positive");
+        }
+    }
+
+    ~load_generator()                                = default;
+    load_generator(const load_generator&)            = default;
+    load_generator& operator=(const load_generator&) = default;
+    load_generator(load_generator&&)                 = default;
+    load_generator& operator=(load_generator&&)      = default;
+
+    const load_options& options() const noexcept { return _opts; }
+
+    template <typename FUNC>
+    load_report run(FUNC&& call) const
+    {
+        std::vector<worker_t>     workers(_opts._threads);
+        std::vector<std::jthread> threads;
+        std::barrier              startSync(static_cast<std::ptrdiff_t>(_opts._threads + 1));
+        clock_t::time_point       start;
+
+        for (unsigned t = 0; t < _opts._threads; ++t) {
+            threads.emplace_back([&, t] {
+                startSync.arrive_and_wait();
+                work(call, t, start, workers[t]);
+            });
+        }
+        start = clock_t::now() + std::chrono::milliseconds(1);   // all threads ready
+        startSync.arrive_and_wait();
+        threads.clear();   // join
+
+        load_report r;
+        r._targetRate = _opts._rate;
+        clock_t::time_point last(start);
+        for (const auto& w : workers) {
+            r._response += w._response;
+            r._service  += w._service;
+            r._calls    += w._calls;
+            r._maxLag    = std::max(r._maxLag, w._maxLag);
+            last         = std::max(last, w._last);
+        }
+        const std::chrono::duration<double> elapsed(last - start);
+        r._achievedRate = elapsed.count() > 0 ? static_cast<double>(r._calls) / elapsed.count() : 0;
+        return r;
+    }
+
+private:
+
+    struct worker_t
+    {
+        load_report::dataset_t  _response{"Response ns"};
+        load_report::dataset_t  _service{"Service ns"};
+        std::uint64_t           _calls = 0;
+        timepoint::duration_t   _maxLag{};
+        clock_t::time_point     _last{};
+    };
+
+    template <typename FUNC>
+    void work(FUNC& call, unsigned thread, clock_t::time_point start, worker_t& w) const
+    {
+        using ns = std::chrono::nanoseconds;
+
+        const double               perThread(_opts._rate / _opts._threads);
+        const double               gap(1e9 / perThread);   // mean, ns
+        const clock_t::time_point  stop(start + _opts._duration);
+
+        std::mt19937_64                  rng(_opts._seed + thread);
+        std::exponential_distribution<>  exponential(1 / gap);
+        auto next_gap = [&]() -> double {
+            return _opts._arrivals == arrivals::poisson ? exponential(rng) : gap;
+        };
+
+        // Fixed: threads interleave; poisson: independent streams
+        double offset(_opts._arrivals == arrivals::poisson ? next_gap() : gap * thread / _opts._threads);
+        for (auto intended = start + ns(static_cast<ns::rep>(offset)); intended < stop;
+                  intended = start + ns(static_cast<ns::rep>(offset))) {
+            wait_until(intended);
+
+            const auto began(clock_t::now());
+            if constexpr (std::is_invocable_v<FUNC&, unsigned>) {
+                call(thread);
+            } else {
+                call();
+            }
+            const auto done(clock_t::now());
+
+            w._response(static_cast<double>(std::chrono::duration_cast<ns>(done - intended).count()));
+            w._service(static_cast<double>(std::chrono::duration_cast<ns>(done - began).count()));
+            w._maxLag = std::max(w._maxLag, std::chrono::duration_cast<timepoint::duration_t>(began - intended));
+            w._last   = done;
+            ++w._calls;
+
+            offset += next_gap();
+        }
+    }
+
+    /// Sleeps most of the way, then spins: sleeps overshoot by tens of us
+    static void wait_until(clock_t::time_point when)
+    {
+        constexpr auto spin(std::chrono::microseconds(100));
+        if (const auto now = clock_t::now(); when - now > spin) {
+            std::this_thread::sleep_until(when - spin);
+        }
+        while (clock_t::now() < when) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+
+    load_options _opts;
+
+}; // load_generator
+
+} // namespace lpt::chrono
+
+
+#endif //#define INCLUDED_load_generator_hpp_b4e07d19_6a2c_4f85_93d1_0c8e5a7f2b64
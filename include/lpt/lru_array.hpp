@@ -14,21 +14,36 @@
 #define INCLUDED_lru_array_hpp_025884f0_0423_46a1_bf95_5481fe40426b
 #pragma once
 
+#include <lpt/admission.hpp>
+#include <lpt/chrono.hpp>
+#include <lpt/eviction.hpp>
+#include <lpt/lru_counters.hpp>
+
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cassert>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <iostream>
 #include <iterator>
-#include <map>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <set>
-#include <unordered_map>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__)
+#  include <immintrin.h>
+#endif
 
 namespace lpt {
 
 /*
- * As a custom priority queue
+ * As a custom priority queue.
+ * @see lpt/indexed_heap.hpp for a contiguous one with update by handle.
  */
 template <typename T,
           typename COMPARE_T = std::less<T>
@@ -52,6 +67,11 @@ public:
         _data.erase(_data.begin());
     }
 
+    void erase(const T& data)
+    {
+        _data.erase(data);
+    }
+
     const T& top() const
     {
         return *_data.begin();
@@ -70,40 +90,297 @@ private:
 
 }; // ordered_set
 
+
+namespace detail {
+
 /*
- * Store a specified max number of items, replace the oldest 
- * when full.
+ * Open-addressed, linear probing KEY->slot index with backward-shift
+ * deletion. Keys are not stored here: the caller provides a predicate
+ * to compare the key living in a slot. Fixed size, no allocation.
  */
-template <typename    KEY,
-          typename    T, 
-          std::size_t N
->
-class lru_array
+template <std::size_t N>
+class hash_index
 {
-private: 
+public:
+
+    static constexpr std::size_t CAPACITY = std::bit_ceil(std::max<std::size_t>(2*N, 2));
+    static constexpr std::size_t MASK     = CAPACITY - 1;
+
+    static_assert(N < npos, "Too many slots");
+
+    /// @return the slot holding the key matching @param isKey or npos
+    template <typename KEY, typename PRED>
+    slot_t find(const KEY& /*key*/, std::uint64_t hash, PRED&& isKey) const noexcept
+    {
+        for (std::size_t pos = hash & MASK; ; pos = (pos + 1) & MASK) {
+            const auto& e(_table[pos]);
+            if (e._slot == npos) {
+                return npos;
+            }
+            if (e._hash == static_cast<std::uint32_t>(hash) && isKey(e._slot)) {
+                return e._slot;
+            }
+        }
+    }
+
+    /// The key must not be present
+    template <typename KEY>
+    void insert(const KEY& /*key*/, std::uint64_t hash, slot_t slot) noexcept
+    {
+        std::size_t pos = hash & MASK;
+        while (_table[pos]._slot != npos) {
+            pos = (pos + 1) & MASK;
+        }
+        _table[pos] = {slot, static_cast<std::uint32_t>(hash)};
+    }
+
+    /// The key must be present in @param slot
+    template <typename KEY>
+    void erase(const KEY& /*key*/, std::uint64_t hash, slot_t slot) noexcept
+    {
+        std::size_t pos = hash & MASK;
+        while (_table[pos]._slot != slot) {
+            assert(_table[pos]._slot != npos);
+            pos = (pos + 1) & MASK;
+        }
+
+        // Backward shift: pull back entries displaced past the hole
+        for (std::size_t next = (pos + 1) & MASK; ; next = (next + 1) & MASK) {
+            const auto& e(_table[next]);
+            if (e._slot == npos) {
+                break;
+            }
+            const std::size_t home = e._hash & MASK;
+            if (((next - home) & MASK) >= ((next - pos) & MASK)) {
+                _table[pos] = e;
+                pos         = next;
+            }
+        }
+        _table[pos] = entry{};
+    }
+
+    void clear() noexcept
+    {
+        _table.fill(entry{});
+    }
+
+private:
+
+    struct entry
+    {
+        slot_t         _slot = npos;
+        std::uint32_t  _hash = 0;   // low bits of the key hash
+    };
+
+    std::array<entry, CAPACITY> _table{};
+
+}; // hash_index
+
+/*
+ * For small N and integral keys: the keys are stored contiguously, by
+ * slot, and compared all at once with AVX2 (if the CPU has it) or SSE2;
+ * a bitmask tracks the used slots. No probing.
+ */
+template <typename KEY, std::size_t N>
+inline constexpr bool simd_index_eligible = (std::is_integral_v<KEY> || std::is_enum_v<KEY>)
+                                            && ! std::is_same_v<KEY, bool>
+                                            && (sizeof(KEY) == 4 || sizeof(KEY) == 8)
+                                            && N <= 64;
+
+#if defined(__x86_64__)
+inline const bool has_avx2 = []{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+}();
+#endif
+
+template <typename KEY, std::size_t N>
+class simd_index
+{
+public:
+
+    static_assert(simd_index_eligible<KEY, N>);
+
+    static constexpr std::size_t VECTOR_BYTES = 32;
+    static constexpr std::size_t PER_VECTOR   = VECTOR_BYTES / sizeof(KEY);
+    static constexpr std::size_t CAPACITY     = (N + PER_VECTOR - 1) / PER_VECTOR * PER_VECTOR;
+
+    template <typename PRED>
+    slot_t find(const KEY& key, std::uint64_t /*hash*/, PRED&& /*isKey*/) const noexcept
+    {
+        const std::uint64_t found(match(key) & _used);
+        return found ? static_cast<slot_t>(std::countr_zero(found)) : npos;
+    }
+
+    void insert(const KEY& key, std::uint64_t /*hash*/, slot_t slot) noexcept
+    {
+        _keys[slot]  = key;
+        _used       |= std::uint64_t(1) << slot;
+    }
 
-    using clock_t = std::chrono::high_resolution_clock;
-    using stamp_t = clock_t::time_point;
+    void erase(const KEY& /*key*/, std::uint64_t /*hash*/, slot_t slot) noexcept
+    {
+        _used &= ~(std::uint64_t(1) << slot);
+    }
+
+    void clear() noexcept
+    {
+        _keys.fill(KEY{});
+        _used = 0;
+    }
+
+private:
 
-    struct IdxItem
+    using bits_t = std::conditional_t<sizeof(KEY) == 4, std::uint32_t, std::uint64_t>;
+
+    /// Bitmask of the slots equal to @param key, used or not
+    std::uint64_t match(const KEY& key) const noexcept
     {
-        std::reference_wrapper<T>    _data; // TODO: redundant since we have the idx?
-        size_t                       _idx = 0;  // in _data
-        KEY                          _key;
-        stamp_t                      _stamp;
+#if defined(__x86_64__)
+        if (has_avx2) {
+            return match_avx2(key);
+        }
+        return match_sse2(key);
+#else
+        return match_scalar(key);
+#endif
+    }
 
-        friend std::ostream& operator<<(std::ostream& os, const IdxItem& i)
-        {
-            os << '(' << i._key << ',' << i._idx /*<< ',' << i._stamp*/ << ')';
-            return os;
+    std::uint64_t match_scalar(const KEY& key) const noexcept
+    {
+        std::uint64_t found(0);
+        for (std::size_t i = 0; i < N; ++i) {
+            found |= std::uint64_t(_keys[i] == key) << i;
         }
+        return found;
+    }
+
+#if defined(__x86_64__)
+    __attribute__((target("avx2")))
+    std::uint64_t match_avx2(const KEY& key) const noexcept
+    {
+        const auto*   keys(reinterpret_cast<const __m256i*>(_keys.data()));
+        std::uint64_t found(0);
+
+        if constexpr (sizeof(KEY) == 4) {
+            const __m256i k(_mm256_set1_epi32(static_cast<int>(static_cast<bits_t>(key))));
+            for (std::size_t v = 0; v < CAPACITY / PER_VECTOR; ++v) {
+                const __m256i eq(_mm256_cmpeq_epi32(_mm256_load_si256(keys + v), k));
+                found |= std::uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(eq))) << (v * PER_VECTOR);
+            }
+        } else {
+            const __m256i k(_mm256_set1_epi64x(static_cast<long long>(static_cast<bits_t>(key))));
+            for (std::size_t v = 0; v < CAPACITY / PER_VECTOR; ++v) {
+                const __m256i eq(_mm256_cmpeq_epi64(_mm256_load_si256(keys + v), k));
+                found |= std::uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(eq))) << (v * PER_VECTOR);
+            }
+        }
+        return found;
+    }
+
+    std::uint64_t match_sse2(const KEY& key) const noexcept
+    {
+        constexpr std::size_t PER_SSE = 16 / sizeof(KEY);
+
+        const auto*   keys(reinterpret_cast<const __m128i*>(_keys.data()));
+        std::uint64_t found(0);
+
+        if constexpr (sizeof(KEY) == 4) {
+            const __m128i k(_mm_set1_epi32(static_cast<int>(static_cast<bits_t>(key))));
+            for (std::size_t v = 0; v < CAPACITY / PER_SSE; ++v) {
+                const __m128i eq(_mm_cmpeq_epi32(_mm_load_si128(keys + v), k));
+                found |= std::uint64_t(_mm_movemask_ps(_mm_castsi128_ps(eq))) << (v * PER_SSE);
+            }
+        } else {
+            // No 64-bit compare before SSE4.1: both 32-bit halves must match
+            const __m128i k(_mm_set1_epi64x(static_cast<long long>(static_cast<bits_t>(key))));
+            for (std::size_t v = 0; v < CAPACITY / PER_SSE; ++v) {
+                const __m128i eq32(_mm_cmpeq_epi32(_mm_load_si128(keys + v), k));
+                const __m128i eq(_mm_and_si128(eq32, _mm_shuffle_epi32(eq32, _MM_SHUFFLE(2, 3, 0, 1))));
+                found |= std::uint64_t(_mm_movemask_pd(_mm_castsi128_pd(eq))) << (v * PER_SSE);
+            }
+        }
+        return found;
+    }
+#endif
+
+    alignas(VECTOR_BYTES) std::array<KEY, CAPACITY> _keys{};
+    std::uint64_t                                   _used = 0;
+
+}; // simd_index
+
+} // namespace detail
+
+
+/*
+ * Store a specified max number of items, replace the one chosen by the
+ * eviction POLICY when full (default: the least recently used). The
+ * ADMISSION filter can refuse a new key rather than evict (default:
+ * always admit).
+ *
+ * The policy keeps its bookkeeping in fixed arrays indexed by slot, e.g.
+ * a doubly linked list of slot indices for LRU: touching and evicting
+ * are O(1), with no clock reads and no memory allocations.
+ *
+ * Optionally, items have a cost and the container a cost budget (e.g.
+ * bytes): items are evicted until the total cost fits. Items can also
+ * have a time to live, against the coarse clock: expired items are
+ * dropped when accessed, or by a bounded expire() sweep.
+ *
+ * \code
+ *     lpt::lru_array<uint64_t, Item, 1024>                         lru;
+ *     lpt::lru_array<uint64_t, Item, 1024, lpt::eviction::s3fifo>  scanResistant;
+ *     lpt::lru_array<uint64_t, Item, 1024,
+ *                    lpt::eviction::lru, lpt::admission::tinylfu>  frequencyAware;
+ *
+ *     lpt::lru_array<uint64_t, Blob, 1024> blobs(64*1024*1024);    // max 64 MiB
+ *     blobs.push(id, blob, blob.size(), std::chrono::seconds(30));
+ *     blobs.expire(16);                                             // e.g. once per request
+ * \endcode
+ */
+template <typename                  KEY,
+          typename                  T,
+          std::size_t               N,
+          template <std::size_t> class POLICY    = eviction::lru,
+          template <std::size_t> class ADMISSION = admission::always,
+          typename                  COUNTERS  = lru_counters::none
+>
+class lru_array
+{
+private:
+
+    using slot_t  = detail::slot_t;
+    static constexpr slot_t npos = detail::npos;
+
+    using clock_t = lpt::chrono::coarse_clock;
+
+    struct node
+    {
+        KEY            _key{};
+        std::uint64_t  _hash = 0;
+        clock_t::rep   _expiry = 0;   // 0: never
+        std::size_t    _cost = 0;
+        slot_t         _nextFree = npos;   // free list; or make_room()'s victims
+        bool           _used = false;
+        bool           _victim = false;    // picked by make_room()
     };
 
 public:
 
+    using policy_t    = POLICY<N>;
+    using admission_t = ADMISSION<N>;
+    using counters_t  = COUNTERS;
+    using ttl_t       = clock_t::duration;
+
+    static constexpr std::size_t UNLIMITED_COST = std::numeric_limits<std::size_t>::max();
+
     lru_array()   = default;
     ~lru_array()  = default;
 
+    explicit lru_array(std::size_t maxCost)
+        : _maxCost(maxCost)
+    { }
+
     lru_array( const lru_array& other )            = default;
     lru_array& operator=( const lru_array& other ) = default;
 
@@ -121,138 +398,356 @@ public:
         return _data.max_size();
     }
 
-    void push(const KEY& key, const T& data)
+    constexpr bool empty() const noexcept
     {
-        //std::cout << data << ": ";
-
-        auto itKey(_idxData.find(key));
-        if (itKey != _idxData.end()) {
-            auto& item  = itKey->second;
-            auto& stamp = item._stamp;
+        return _numUsed == 0;
+    }
 
-            _data[item._idx] = data;
-            IdxItem newItem{_data[item._idx], item._idx, key, clock_t::now()};
+    constexpr std::size_t total_cost() const noexcept
+    {
+        return _totalCost;
+    }
 
-            auto [itLruB, itLruE] = _idxLru.equal_range(stamp);
-            for (; itLruB != itLruE; ++itLruB) {
-                const auto& lruItem(itLruB->second);
-                if (lruItem._key == key) {
-                    assert(lruItem._key == key);
-                    assert(lruItem._idx == item._idx);
-                    itLruB = _idxLru.erase(itLruB);
-                    break; //continue;
-                }
-            }
-            auto itL = _idxLru.insert({newItem._stamp, newItem});
+    constexpr std::size_t max_cost() const noexcept
+    {
+        return _maxCost;
+    }
 
-            _idxData.erase(key);
-            auto [itD, inD]  = _idxData.insert({newItem._key, newItem});
-            assert(inD);
+    /// Takes effect with the next push
+    void max_cost(std::size_t maxCost) noexcept
+    {
+        _maxCost = maxCost;
+    }
 
-            invariant();
-            return;
-        }
+    /**
+     * @param cost counted against max_cost()
+     * @param ttl  zero: never expires
+     * @return false if the admission filter refused a new key, or if
+     *         @param cost alone exceeds the budget; an item already
+     *         under @param key is then erased
+     */
+    bool push(const KEY& key, const T& data, std::size_t cost = 0, ttl_t ttl = ttl_t::zero())
+    {
+        return emplace(key, data, cost, ttl);
+    }
 
-        if (_numUsed >= max_size()) {
-            const auto& [oldStamp, oldItem] = *_idxLru.begin();
-            auto oldKey(oldItem._key);
-            auto oldIdx(oldItem._idx);
-            assert(oldIdx < max_size());
+    bool push(const KEY& key, T&& data, std::size_t cost = 0, ttl_t ttl = ttl_t::zero())
+    {
+        return emplace(key, std::move(data), cost, ttl);
+    }
 
-            //std::cout << "out->" << oldItem;
+    /// @return the data for @param key or nullptr; a hit refreshes recency
+    T* find(const KEY& key)
+    {
+        const auto h(hash(key));
+        slot_t     idx(lookup(key, h));
+        _admission.on_access(h);
+        if (idx != npos && expired(idx, now(idx))) {
+            remove(idx);
+            _counters.count(lru_counters::event::expired);
+            idx = npos;
+        }
+        if (idx == npos) {
+            _counters.count(lru_counters::event::miss);
+            return nullptr;
+        }
+        _counters.count(lru_counters::event::hit);
+        _policy.on_hit(idx);
+        return &_data[idx];
+    }
 
-            _data[oldIdx] = data;
-            IdxItem newItem{_data[oldIdx], oldIdx, key, clock_t::now()};
+    /// @return a copy of the data for @param key; a hit refreshes recency
+    std::optional<T> get(const KEY& key)
+    {
+        if (const T* p = find(key); p) {
+            return *p;
+        }
+        return std::nullopt;
+    }
 
-            auto [itLruB, itLruE] = _idxLru.equal_range(oldStamp);
-            assert(itLruB != _idxLru.end());
-            const auto& lruItem(itLruB->second);
-            assert(lruItem._key != key);
-            itLruB = _idxLru.erase(itLruB);
+    /// Does not refresh recency
+    bool contains(const KEY& key) const
+    {
+        const slot_t idx(lookup(key, hash(key)));
+        return idx != npos && ! expired(idx, now(idx));
+    }
 
-            auto itL = _idxLru.insert({newItem._stamp, newItem});
+    bool erase(const KEY& key)
+    {
+        const slot_t idx(lookup(key, hash(key)));
+        if (idx == npos) {
+            return false;
+        }
 
-            _idxData.erase(oldKey);
-            auto [itD, inD]  = _idxData.insert({newItem._key, newItem});
-            assert(inD);
+        remove(idx);
+        return true;
+    }
 
-            invariant();
-            return;
+    /// Visit up to @param maxSlots slots, resuming where the previous call stopped
+    /// @return the number of expired items dropped
+    std::size_t expire(std::size_t maxSlots)
+    {
+        if (_numSlots == 0) {
+            return 0;
         }
 
-        _data[_numUsed] = data;
-        IdxItem newItem{_data[_numUsed], _numUsed, key, clock_t::now()};
-
-        auto itL = _idxLru.insert({newItem._stamp, newItem});
+        const auto  tnow(clock_t::now().time_since_epoch().count());
+        std::size_t numExpired(0);
+        for (std::size_t i = 0; i < std::min<std::size_t>(maxSlots, _numSlots); ++i) {
+            _sweep = (_sweep + 1) % _numSlots;
+            if (_nodes[_sweep]._used && expired(_sweep, tnow)) {
+                remove(_sweep);
+                _counters.count(lru_counters::event::expired);
+                ++numExpired;
+            }
+        }
+        return numExpired;
+    }
 
-        auto [itD, inD]  = _idxData.insert({newItem._key, newItem});
-        assert(inD);
+    /// Running totals; empty with lru_counters::none. Not reset by clear().
+    lru_counters::snapshot counters() const noexcept
+    {
+        return _counters.read();
+    }
 
-        ++_numUsed;
+    /// Move every deadline by @param delta, e.g. for an image saved under another clock epoch
+    void shift_expiry(ttl_t delta) noexcept
+    {
+        for (slot_t idx = 0; idx < _numSlots; ++idx) {
+            if (auto& expiry(_nodes[idx]._expiry); expiry) {
+                expiry = std::max<clock_t::rep>(expiry + delta.count(), 1);
+            }
+        }
+    }
 
-        invariant();
+    void clear()
+    {
+        _data.fill(T{});
+        _nodes.fill(node{});
+        _numUsed   = 0;
+        _numSlots  = 0;
+        _free      = npos;
+        _sweep     = 0;
+        _totalCost = 0;
+        _idxData.clear();
+
+        // In place: policies and filters can be large
+        std::destroy_at(&_policy);
+        std::construct_at(&_policy);
+        std::destroy_at(&_admission);
+        std::construct_at(&_admission);
     }
 
     friend std::ostream& operator<<(std::ostream& os, const lru_array& a)
     {
         os << "D [";
-        //std::copy(a._data.cbegin(), a._data.cend(), std::ostream_iterator<T>(os, ","));
-        std::for_each(a._data.cbegin(), a._data.cend(), [&os](const auto& item){ os << item;});
-        os << "]\nID[";
-        std::for_each(a._idxData.cbegin(), a._idxData.cend(), [&os](const auto& item){ os << item.second;});
+        a._policy.for_each([&os, &a](slot_t idx){ os << a._data[idx]; });
         os << "]\nIT[";
-        std::for_each(a._idxLru.cbegin(), a._idxLru.cend(), [&os](const auto& item){ os << item.second;});
+        a._policy.for_each([&os, &a](slot_t idx){ os << '(' << a._nodes[idx]._key << ',' << idx << ')'; });
         os << "]\n";
         return os;
     }
 
 private:
 
-    void invariant() const
+    static std::uint64_t hash(const KEY& key)
     {
-        //std::cout << "*** " << _numUsed 
-        //          << " *** " << _idxLru.size() << '[' << _idxLru.begin()->second << ']'
-        //          << " *** " << _idxData.size() << "\n";
-        //std::cout << *this;
-        assert(_numUsed <= _data.max_size());
-        assert(_numUsed == _idxLru.size());
-        assert(_numUsed == _idxData.size());
+        return detail::mix_hash(std::hash<KEY>{}(key));
+    }
+
+    slot_t lookup(const KEY& key, std::uint64_t h) const
+    {
+        return _idxData.find(key, h, [this, &key](slot_t idx){ return _nodes[idx]._key == key; });
     }
 
-private: 
+    // Read the clock only for items with a time to live
+    clock_t::rep now(slot_t idx) const noexcept
+    {
+        return _nodes[idx]._expiry ? clock_t::now().time_since_epoch().count() : 0;
+    }
 
-    std::array<T, N>    _data;
-    size_t              _numUsed{0};
+    bool expired(slot_t idx, clock_t::rep tnow) const noexcept
+    {
+        const auto expiry(_nodes[idx]._expiry);
+        return expiry && expiry <= tnow;
+    }
+
+    static clock_t::rep expiry(ttl_t ttl) noexcept
+    {
+        return ttl > ttl_t::zero() ? (clock_t::now() + ttl).time_since_epoch().count() : 0;
+    }
+
+    template <typename U>
+    bool emplace(const KEY& key, U&& data, std::size_t cost, ttl_t ttl)
+    {
+        const auto h(hash(key));
+        _admission.on_access(h);
+
+        const slot_t idx(lookup(key, h));
+        if (cost > _maxCost) {
+            // Never fits: do not keep serving the old value
+            if (idx != npos) {
+                remove(idx);
+            }
+            return false;
+        }
+
+        if (idx != npos) {
+            _totalCost         = _totalCost - _nodes[idx]._cost + cost;
+            _data[idx]         = std::forward<U>(data);
+            _nodes[idx]._cost   = cost;
+            _nodes[idx]._expiry = expiry(ttl);
+            _policy.on_hit(idx);
+            _counters.count(lru_counters::event::update);
+            shrink(idx);
+
+            invariant();
+            return true;
+        }
+
+        if ( ! make_room(h, cost)) {
+            return false;
+        }
+
+        const slot_t slot(acquire());
+        assert(slot != npos);
+
+        _data[slot]          = std::forward<U>(data);
+        _nodes[slot]._key    = key;
+        _nodes[slot]._hash   = h;
+        _nodes[slot]._expiry = expiry(ttl);
+        _nodes[slot]._cost   = cost;
+        _nodes[slot]._used   = true;
+        _idxData.insert(key, h, slot);
+        _policy.on_insert(slot, h);
+        _totalCost += cost;
+        ++_numUsed;
+
+        invariant();
+        return true;
+    }
 
     /*
-    using lruidx_t = std::priority_queue<
-                        IdxItem,
-                        std::deque<IdxItem>,
-                        decltype([](const IdxItem& lhs, const IdxItem& rhs){
-                            return lhs._data.get()._stamp >= rhs._data.get()._stamp;
-                        })
-                     >;
-    */
-    /*
-    using lruidx_t = ordered_set<
-                        IdxItem,
-                        decltype([](const IdxItem& lhs, const IdxItem& rhs){
-                            return lhs._data.get()._stamp < rhs._data.get()._stamp;
-                        })
-                     >;
-    */
-    // TODO: use a multiset?
-    using lruidx_t = std::multimap<
-                          stamp_t,
-                          IdxItem
-                      >;
-    lruidx_t           _idxLru;
-
-    using dataidx_t = std::unordered_map<
-                          KEY,
-                          IdxItem
-                      >;
-    dataidx_t          _idxData;
+     * A free slot and @param cost under the budget for new key @param h.
+     * All the victims are picked first: the admission filter must admit
+     * the key against each, else none is evicted.
+     */
+    bool make_room(std::uint64_t h, std::size_t cost)
+    {
+        if (_numUsed < N && _totalCost + cost <= _maxCost) {
+            return true;
+        }
+
+        const auto picked([this](slot_t idx) { return _nodes[idx]._victim; });
+
+        slot_t      first(npos), last(npos);
+        std::size_t count(0), freed(0);
+        bool        admitted(true);
+        while (_numUsed - count == N || _totalCost - freed + cost > _maxCost) {
+            const slot_t victim(_policy.victim(picked));
+            assert(victim < N && ! _nodes[victim]._victim);
+
+            _nodes[victim]._victim = true;
+            (first == npos ? first : _nodes[last]._nextFree) = victim;
+            last = victim;
+            ++count;
+            freed += _nodes[victim]._cost;
+
+            if ( ! _admission.admit(h, _nodes[victim]._hash)) {
+                admitted = false;
+                break;
+            }
+        }
+
+        // In the order picked
+        for (slot_t idx = first; idx != npos; ) {
+            const slot_t next(idx == last ? npos : _nodes[idx]._nextFree);
+            _nodes[idx]._victim   = false;
+            _nodes[idx]._nextFree = npos;
+            if (admitted) {
+                evict(idx);
+            }
+            idx = next;
+        }
+        return admitted;
+    }
+
+    // Over budget after an update: evict others, never @param keep, which
+    // keeps its policy state. It fits alone, so others are left to evict.
+    void shrink(slot_t keep)
+    {
+        while (_totalCost > _maxCost) {
+            evict(_policy.victim([keep](slot_t idx) { return idx == keep; }));
+        }
+    }
+
+    void evict(slot_t idx)
+    {
+        _idxData.erase(_nodes[idx]._key, _nodes[idx]._hash, idx);
+        _policy.on_evict(idx);
+        release(idx);
+        _counters.count(lru_counters::event::eviction);
+    }
+
+    void remove(slot_t idx)
+    {
+        _idxData.erase(_nodes[idx]._key, _nodes[idx]._hash, idx);
+        _policy.on_erase(idx);
+        release(idx);
+
+        invariant();
+    }
+
+    // A never used slot or one from the free list
+    slot_t acquire() noexcept
+    {
+        if (_free != npos) {
+            const slot_t idx(_free);
+            _free = _nodes[idx]._nextFree;
+            return idx;
+        }
+        if (_numSlots < N) {
+            return _numSlots++;
+        }
+        return npos;
+    }
+
+    void release(slot_t idx)
+    {
+        _totalCost -= _nodes[idx]._cost;
+
+        _data[idx]  = T{};
+        _nodes[idx] = node{};
+        _nodes[idx]._nextFree = _free;
+        _free = idx;
+        --_numUsed;
+    }
+
+    void invariant() const
+    {
+        assert(_numUsed <= _data.max_size());
+        assert(_numUsed <= _numSlots);
+        assert(_numUsed > 0 || _totalCost == 0);
+    }
+
+private:
+
+    std::array<T, N>     _data{};
+    std::array<node, N>  _nodes{};
+    size_t               _numUsed{0};
+    slot_t               _numSlots{0};  // high water mark
+    slot_t               _free{npos};   // released slots, linked through _nextFree
+    slot_t               _sweep{0};     // expire() cursor
+    std::size_t          _totalCost{0};
+    std::size_t          _maxCost{UNLIMITED_COST};
+    policy_t             _policy;
+    admission_t          _admission;
+    [[no_unique_address]] counters_t _counters;
+
+    using dataidx_t = std::conditional_t<detail::simd_index_eligible<KEY, N>,
+                                         detail::simd_index<KEY, N>,
+                                         detail::hash_index<N>>;
+    dataidx_t            _idxData;
 
 }; // lru_array
 
@@ -0,0 +1,178 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  \brief Optional hit/miss/eviction counters for lru_array; C++20
+ *
+ */
+
+#ifndef INCLUDED_lru_counters_hpp_c61f0b8e_2d49_4a73_b5e8_93a7d1f4e026
+#define INCLUDED_lru_counters_hpp_c61f0b8e_2d49_4a73_b5e8_93a7d1f4e026
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+namespace lpt {
+
+/*
+ * lru_array COUNTERS parameter:
+ *
+ *     void     count(event e) noexcept;
+ *     snapshot read() const noexcept;
+ *
+ * none compiles away; plain is for single threaded use and keeps
+ * lru_array trivially copyable (@see mapped_lru_array); relaxed can be
+ * read from another thread, e.g. a reporter, while the cache is in use.
+ *
+ * \code
+ *     lpt::lru_array<uint64_t, Item, 1024, lpt::eviction::lru,
+ *                    lpt::admission::always, lpt::lru_counters::relaxed> lru;
+ *     auto before(lru.counters());
+ *     ...
+ *     std::cout << lru.counters() - before;
+ * \endcode
+ */
+namespace lru_counters {
+
+enum class event : unsigned
+{
+    hit,
+    miss,
+    eviction,   // by the policy, to make room
+    update,     // push of a present key
+    expired,    // dropped by find() or expire()
+
+    COUNT
+};
+
+struct snapshot
+{
+    std::array<std::uint64_t, static_cast<std::size_t>(event::COUNT)> _counts{};
+
+    std::uint64_t operator[](event e) const noexcept
+    {
+        return _counts[static_cast<std::size_t>(e)];
+    }
+
+    std::uint64_t lookups() const noexcept
+    {
+        return (*this)[event::hit] + (*this)[event::miss];
+    }
+
+    /// [0, 1]; 0 without lookups
+    double hit_ratio() const noexcept
+    {
+        const auto n(lookups());
+        return n ? static_cast<double>((*this)[event::hit]) / n : 0;
+    }
+
+    /// Counts over the interval since @param before
+    snapshot operator-(const snapshot& before) const noexcept
+    {
+        snapshot s;
+        for (std::size_t i = 0; i < _counts.size(); ++i) {
+            s._counts[i] = _counts[i] - before._counts[i];
+        }
+        return s;
+    }
+
+    snapshot& operator+=(const snapshot& other) noexcept
+    {
+        for (std::size_t i = 0; i < _counts.size(); ++i) {
+            _counts[i] += other._counts[i];
+        }
+        return *this;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const snapshot& s)
+    {
+        os << "hits, misses, evictions, updates, expired, hit%\n"
+           << s[event::hit]      << ", "
+           << s[event::miss]     << ", "
+           << s[event::eviction] << ", "
+           << s[event::update]   << ", "
+           << s[event::expired]  << ", "
+           << 100 * s.hit_ratio()
+           << '\n';
+        return os;
+    }
+}; // snapshot
+
+struct none
+{
+    void count(event) noexcept {}
+    snapshot read() const noexcept { return {}; }
+};
+
+struct plain
+{
+    void count(event e) noexcept
+    {
+        ++_counts._counts[static_cast<std::size_t>(e)];
+    }
+
+    snapshot read() const noexcept
+    {
+        return _counts;
+    }
+
+private:
+
+    snapshot _counts;
+};
+
+class relaxed
+{
+public:
+
+    relaxed()  = default;
+    ~relaxed() = default;
+
+    // lru_array stays copyable
+    relaxed(const relaxed& other) noexcept
+    {
+        *this = other;
+    }
+
+    relaxed& operator=(const relaxed& other) noexcept
+    {
+        for (std::size_t i = 0; i < _counts.size(); ++i) {
+            _counts[i].store(other._counts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    // Single writer: no need for a locked add
+    void count(event e) noexcept
+    {
+        auto& c(_counts[static_cast<std::size_t>(e)]);
+        c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    snapshot read() const noexcept
+    {
+        snapshot s;
+        for (std::size_t i = 0; i < _counts.size(); ++i) {
+            s._counts[i] = _counts[i].load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+private:
+
+    std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(event::COUNT)> _counts{};
+};
+
+} // namespace lru_counters
+
+} //namespace lpt
+
+
+#endif //#define INCLUDED_lru_counters_hpp_c61f0b8e_2d49_4a73_b5e8_93a7d1f4e026
@@ -0,0 +1,63 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under LGPL 3.0 or later.
+ *
+ *  \brief lru_array hit ratio stats container
+ */
+
+#pragma once
+
+#include <lpt/lru_counters.hpp>
+#include <lpt/stats.hpp>
+
+namespace lpt::lru_counters
+{
+
+/**
+ * Hit ratio, in percents, of successive intervals.
+ *
+\code
+
+   lpt::lru_counters::dataset hitRatio("Sessions hit%");
+   auto before(cache.counters());
+   for (;;) {
+       std::this_thread::sleep_for(1s);
+       const auto now(cache.counters());
+       hitRatio(now, before);
+       before = now;
+   }
+   std::cout << hitRatio;
+
+\endcode
+ */
+struct dataset : public lpt::stats::dataset
+{
+    using value_t = lpt::stats::dataset::value_t;
+
+    using lpt::stats::dataset::dataset;
+
+    /// Since the cache was created
+    void operator()(const snapshot& data)
+    {
+        sample(data);
+    }
+
+    /// Over the interval between @param before and @param data; ignored without lookups
+    void operator()(const snapshot& data, const snapshot& before)
+    {
+        sample(data - before);
+    }
+
+private:
+
+    void sample(const snapshot& data)
+    {
+        if (data.lookups()) {
+            _stats(static_cast<value_t>(100 * data.hit_ratio()));
+        }
+    }
+};
+
+} // namespace lpt::lru_counters
@@ -0,0 +1,270 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  \brief lru_array living in a file-backed mmap, for warm restarts; Linux, C++20
+ *
+ */
+
+#ifndef INCLUDED_mapped_lru_array_hpp_5e2d8a91_7b3f_4c60_9a1e_d84f02c7b6a3
+#define INCLUDED_mapped_lru_array_hpp_5e2d8a91_7b3f_4c60_9a1e_d84f02c7b6a3
+
+#pragma once
+
+#include <lpt/chrono.hpp>
+#include <lpt/crc32.hpp>
+#include <lpt/lru_array.hpp>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lpt {
+
+/*
+ * An lru_array in a MAP_SHARED file mapping. lru_array links its slots,
+ * recency lists and hash index by array index, never by pointer, so the
+ * image is valid at whatever address it is mapped back.
+ *
+ * The file is a header followed by the lru_array image. The image is
+ * reused only if the header has the same version and layout and the
+ * image was closed cleanly with a matching crc32; otherwise the cache
+ * starts empty. While mapped, the image is flagged open: a crash leaves
+ * it flagged and it is rejected on the next start. One process at a time:
+ * the file is flock()ed while mapped.
+ *
+ * Deadlines are rebased on reload, so TTLs keep counting across a
+ * restart or a reboot.
+ *
+ * KEY and T must be trivially copyable, and std::hash<KEY> must give
+ * the same values from one build to the next.
+ *
+ * \code
+ *     lpt::mapped_lru_array<uint64_t, Quote, 1024*1024> quotes("/var/cache/quotes.lru");
+ *     if ( ! quotes.warm()) {...}
+ *     quotes->push(id, q);
+ * \endcode
+ */
+template <typename                     KEY,
+          typename                     T,
+          std::size_t                  N,
+          template <std::size_t> class POLICY    = eviction::lru,
+          template <std::size_t> class ADMISSION = admission::always,
+          typename                     COUNTERS  = lru_counters::none
+>
+class mapped_lru_array
+{
+public:
+
+    using lru_array_t = lru_array<KEY, T, N, POLICY, ADMISSION, COUNTERS>;
+
+    static_assert(std::is_trivially_copyable_v<KEY>, "KEY must be trivially copyable");
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    static_assert(std::is_trivially_copyable_v<lru_array_t>, "POLICY, ADMISSION and COUNTERS must be trivially copyable");
+
+    static constexpr std::uint32_t VERSION = 1;
+
+    explicit mapped_lru_array(const std::string& path)
+    {
+        _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (_fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+        }
+        if (::flock(_fd, LOCK_EX | LOCK_NB) != 0) {
+            if (errno == EWOULDBLOCK) {
+                errno = EBUSY;
+            }
+            fail("flock " + path + ": mapped by another process");
+        }
+
+        struct stat st;
+        if (::fstat(_fd, &st) != 0) {
+            fail("fstat " + path);
+        }
+        const bool sized(static_cast<std::size_t>(st.st_size) == FILE_SIZE);
+        if ( ! sized && ::ftruncate(_fd, FILE_SIZE) != 0) {
+            fail("ftruncate " + path);
+        }
+
+        void* p(::mmap(nullptr, FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0));
+        if (p == MAP_FAILED) {
+            fail("mmap " + path);
+        }
+        _base = static_cast<std::byte*>(p);
+
+        _warm = sized && valid();
+        if (_warm) {
+            rebase();
+        } else {
+            std::construct_at(&image());
+        }
+
+        header() = header_t{};   // flagged open
+        ::msync(_base, sizeof(header_t), MS_SYNC);
+    }
+
+    ~mapped_lru_array()
+    {
+        close();
+    }
+
+    mapped_lru_array(const mapped_lru_array&)            = delete;
+    mapped_lru_array& operator=(const mapped_lru_array&) = delete;
+    mapped_lru_array(mapped_lru_array&&)                 = delete;
+    mapped_lru_array& operator=(mapped_lru_array&&)      = delete;
+
+    /// @return true if the image of a previous run was reused
+    bool warm() const noexcept
+    {
+        return _warm;
+    }
+
+    lru_array_t& operator*() noexcept             { return image(); }
+    const lru_array_t& operator*() const noexcept { return image(); }
+    lru_array_t* operator->() noexcept            { return &image(); }
+    const lru_array_t* operator->() const noexcept { return &image(); }
+
+    /// Write dirty pages back; the image stays flagged open
+    void sync()
+    {
+        if (_base && ::msync(_base, FILE_SIZE, MS_SYNC) != 0) {
+            throw std::system_error(errno, std::generic_category(), "msync");
+        }
+    }
+
+    /// Checksum the image, flag it clean and unmap. Not thread safe.
+    void close() noexcept
+    {
+        if (_base) {
+            ::msync(_base, FILE_SIZE, MS_SYNC);
+
+            auto& h(header());
+            h._crc         = checksum();
+            h._wallClock   = std::chrono::system_clock::now().time_since_epoch() / std::chrono::nanoseconds(1);
+            h._coarseClock = clock_t::now().time_since_epoch().count();
+            h._state       = CLEAN;
+            ::msync(_base, sizeof(header_t), MS_SYNC);
+
+            ::munmap(_base, FILE_SIZE);
+            _base = nullptr;
+        }
+        if (_fd >= 0) {
+            ::close(_fd);
+            _fd = -1;
+        }
+    }
+
+private:
+
+    using clock_t = lpt::chrono::coarse_clock;
+
+    enum : std::uint32_t { OPEN = 1, CLEAN = 2 };
+
+    static constexpr std::uint64_t MAGIC = 0x59415252414c5450ULL;  // "PTLARRAY"
+
+    struct header_t
+    {
+        std::uint64_t  _magic       = MAGIC;
+        std::uint32_t  _version     = VERSION;
+        std::uint32_t  _state       = OPEN;
+        std::uint64_t  _layout      = layout();
+        std::uint32_t  _crc         = 0;
+        std::int64_t   _wallClock   = 0;   // system_clock ns at close
+        std::int64_t   _coarseClock = 0;   // clock_t ns at close
+    };
+
+    static constexpr std::size_t IMAGE_OFFSET = (sizeof(header_t) + alignof(lru_array_t) - 1) / alignof(lru_array_t) * alignof(lru_array_t);
+    static constexpr std::size_t FILE_SIZE    = IMAGE_OFFSET + sizeof(lru_array_t);
+
+    // FNV-1a of the compiler's name of lru_array_t: KEY, T, N and the policies
+    static constexpr std::uint64_t type_hash() noexcept
+    {
+        const std::string_view name(__PRETTY_FUNCTION__);
+        std::uint64_t          h(0xcbf29ce484222325ULL);
+        for (const char c : name) {
+            h = (h ^ static_cast<unsigned char>(c)) * 0x100000001b3ULL;
+        }
+        return h;
+    }
+
+    // Anything that changes the image layout or its meaning
+    static constexpr std::uint64_t layout() noexcept
+    {
+        std::uint64_t h(type_hash());
+        for (std::uint64_t v : {sizeof(KEY), alignof(KEY), sizeof(T), alignof(T), sizeof(lru_array_t), alignof(lru_array_t)}) {
+            h = detail::mix_hash(h ^ v);
+        }
+        return h;
+    }
+
+    header_t& header() noexcept
+    {
+        return *reinterpret_cast<header_t*>(_base);
+    }
+
+    lru_array_t& image() noexcept
+    {
+        return *reinterpret_cast<lru_array_t*>(_base + IMAGE_OFFSET);
+    }
+
+    const lru_array_t& image() const noexcept
+    {
+        return *reinterpret_cast<const lru_array_t*>(_base + IMAGE_OFFSET);
+    }
+
+    std::uint32_t checksum() const noexcept
+    {
+        return static_cast<std::uint32_t>(lpt::algo::crc32(_base + IMAGE_OFFSET, sizeof(lru_array_t), 0));
+    }
+
+    bool valid() noexcept
+    {
+        const auto& h(header());
+        return h._magic   == MAGIC
+            && h._version == VERSION
+            && h._layout  == layout()
+            && h._state   == CLEAN
+            && h._crc     == checksum();
+    }
+
+    // The coarse clock restarts at boot: carry the remaining TTLs over by wall clock time
+    void rebase() noexcept
+    {
+        const auto&        h(header());
+        const std::int64_t wall(std::chrono::system_clock::now().time_since_epoch() / std::chrono::nanoseconds(1));
+        const std::int64_t coarse(clock_t::now().time_since_epoch().count());
+        image().shift_expiry(clock_t::duration((coarse - h._coarseClock) - (wall - h._wallClock)));
+    }
+
+    [[noreturn]] void fail(const std::string& what)
+    {
+        const int err(errno);
+        close();
+        throw std::system_error(err, std::generic_category(), what);
+    }
+
+private:
+
+    int         _fd   = -1;
+    std::byte*  _base = nullptr;
+    bool        _warm = false;
+
+}; // mapped_lru_array
+
+} //namespace lpt
+
+
+#endif //#define INCLUDED_mapped_lru_array_hpp_5e2d8a91_7b3f_4c60_9a1e_d84f02c7b6a3
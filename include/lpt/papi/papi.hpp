@@ -31,6 +31,7 @@
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <papi.h> 
 
@@ -546,6 +547,20 @@ public:
             return ret;
         }
 
+        /// Less the measurement @param floor, @see counters::calibrate(); clamped to 0
+        datapoint less(const datapoint& floor) const
+        {
+            datapoint ret(*this);
+            for (size_t i = 0; i < size(); ++i )
+            {
+                ret._values[i] = std::max<value_t>(_values[i] - floor._values[i], 0);
+            }
+
+            ret._elapsedTime = std::max(_elapsedTime - floor._elapsedTime, lpt::chrono::timepoint::duration_t::zero());
+
+            return ret;
+        }
+
         percents as_percent_of(const datapoint& base) const
         {
             percents pcts;
@@ -560,7 +575,9 @@ public:
 
             percent_t dataPoint(_elapsedTime.count());
             percent_t basePoint(base._elapsedTime.count());
-            pcts[percents::POS_TIME] = ((dataPoint - basePoint)/basePoint) * 100.0;
+            pcts[percents::POS_TIME] = basePoint != 0
+                                     ? (((dataPoint - basePoint)/basePoint) * 100.0)
+                                     : 0 ;
 
             return pcts;
         }
@@ -661,6 +678,45 @@ public:
 
     }; // measurement
 
+    /**
+     * Per counter and elapsed time medians of @param runs measurements of
+     * an empty region: the floor under every datapoint, which matters for
+     * short regions. Leaves values() as they were.
+     *
+     *  @code
+     *  const counters::datapoint floor(ctrs.calibrate());
+     *  std::cout << floor;
+     *  ...
+     *  stats(data.less(floor), base.less(floor));
+     *  @endcode
+     */
+    datapoint calibrate(unsigned runs = 1001)
+    {
+        const values_t         accumulators(_accumulators);
+        std::vector<datapoint> samples;
+        samples.reserve(runs);
+        for (unsigned i = 0; i < runs; ++i) {
+            measurement m("", *this, [](auto&&) {});
+            samples.push_back(m.data());
+        }
+        _accumulators = accumulators;
+
+        datapoint floor("Measurement floor");
+        auto      median = [&samples](auto&& field) {
+            std::vector<decltype(field(samples[0]))> column;
+            for (const auto& s : samples) {
+                column.push_back(field(s));
+            }
+            std::nth_element(column.begin(), column.begin() + column.size() / 2, column.end());
+            return column[column.size() / 2];
+        };
+        for (size_t i = 0; i < size(); ++i) {
+            floor._values[i] = median([i](const datapoint& d) { return d._values[i]; });
+        }
+        floor._elapsedTime = median([](const datapoint& d) { return d._elapsedTime; });
+        return floor;
+    }
+
 private:
 
     static constexpr const events_t   _events{ EVENTS... };
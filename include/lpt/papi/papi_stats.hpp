@@ -12,7 +12,13 @@
 
 #pragma once
 
-#include <lpt/papi/papi.hpp>
+// The sets take any counters with the datapoint surface, e.g. lpt::perf::counters
+#if __has_include(<papi.h>)
+#  include <lpt/papi/papi.hpp>
+#endif
+#include <lpt/chrono.hpp>
+#include <lpt/hdr_histogram.hpp>
+#include <lpt/sample_log.hpp>
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
@@ -24,12 +30,59 @@
 namespace lpt::papi
 {
 
+/// Optional measurement floor of the accumulator sets, and the samples it made unusable
+template<typename PAPI_COUNTERS> 
+struct measurement_floor 
+{  
+    using datapoint_t = typename PAPI_COUNTERS::datapoint;
+    using percents_t  = typename datapoint_t::percents;
+
+    void subtract(const datapoint_t& value)
+    {
+        _floor = value;
+        _set   = true;
+    }
+
+    datapoint_t net(const datapoint_t& data) const
+    {
+        return _set ? data.less(_floor) : data;
+    }
+
+    /// Net @param data as percents of net @param base; false, and counted, if the base time is not above the floor
+    bool percents(const datapoint_t& data, const datapoint_t& base, percents_t& pcts)
+    {
+        const datapoint_t netBase(net(base));
+        if (netBase.elapsed_time() == lpt::chrono::timepoint::duration_t::zero()) {
+            ++_skipped;
+            return false;
+        }
+        pcts = net(data).as_percent_of(netBase);
+        return true;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const measurement_floor& f)
+    {
+        if (f._set) {
+            os << "Subtracted " << f._floor;
+        }
+        if (f._skipped) {
+            os << "Skipped, base not above the floor: " << f._skipped << '\n';
+        }
+        return os;
+    }
+
+    datapoint_t _floor;
+    bool        _set     = false;
+    std::size_t _skipped = 0;
+};
+
 template<typename PAPI_COUNTERS> 
 struct accumulator_set 
 {  
     using counters_t        = PAPI_COUNTERS;
     using percent_t         = typename counters_t::percent_t;
     using percents_t        = typename counters_t::datapoint::percents;
+    using datapoint_t       = typename counters_t::datapoint;
 
     using accumulator_set_t = boost::accumulators::accumulator_set< percent_t,
                                                                     boost::accumulators::features <
@@ -44,16 +97,36 @@ struct accumulator_set
 
     void operator()(const percents_t& data)
     {
-        for (auto i = 0; i < percents_t::size(); ++i) {
+        for (size_t i = 0; i < percents_t::size(); ++i) {
             _stats[i](data[i]);
         }
     }
 
+    /// @param data as percents of @param base, both less the floor if any; skipped if the base is not above it
+    void operator()(const datapoint_t& data, const datapoint_t& base)
+    {
+        if (percents_t pcts; _floor.percents(data, base, pcts)) {
+            (*this)(pcts);
+        }
+    }
+
+    /// Percent samples dropped for a zero base
+    std::size_t skipped() const noexcept
+    {
+        return _floor._skipped;
+    }
+
+    /// Subtract @param value, @see counters::calibrate(), from datapoints
+    void subtract(const datapoint_t& value)
+    {
+        _floor.subtract(value);
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const accumulator_set& dt)
     {
         os << boost::accumulators::count(dt._stats[0]) << " samples\n"
            << "Counter, min%, max%, mean%, median%, stddev\n";
-        for (auto i = 0; i < percents_t::size(); ++i) {
+        for (size_t i = 0; i < percents_t::size(); ++i) {
             const auto& stat(dt._stats[i]);
             const auto  n(boost::accumulators::count(stat));
             os << percents_t::name(i)               << ", "
@@ -65,11 +138,165 @@ struct accumulator_set
                << '\n';
         }
 
-        return os;
+        return os << dt._floor;
     }
 
-    accumulator_set_t _stats[percents_t::size()];
+    accumulator_set_t    _stats[percents_t::size()];
+    measurement_floor<counters_t> _floor;
 };
 
-} // namespace lpt::papi
+/**
+ * As accumulator_set, with tail percentiles. Percents are kept to
+ * @param unit; negative ones (fewer events than the base) are fine.
+ */
+template<typename PAPI_COUNTERS, unsigned PRECISION_BITS = 7> 
+struct hdr_accumulator_set 
+{  
+    using counters_t        = PAPI_COUNTERS;
+    using percent_t         = typename counters_t::percent_t;
+    using percents_t        = typename counters_t::datapoint::percents;
+    using datapoint_t       = typename counters_t::datapoint;
+
+    using accumulator_set_t = lpt::stats::hdr_accumulator<PRECISION_BITS>;
+
+    explicit hdr_accumulator_set(percent_t unit = 0.01)
+    {
+        for (auto& stat : _stats) {
+            stat = accumulator_set_t(unit);
+        }
+    }
+
+    void operator()(const percents_t& data)
+    {
+        for (size_t i = 0; i < percents_t::size(); ++i) {
+            _stats[i](data[i]);
+        }
+    }
+
+    /// @param data as percents of @param base, both less the floor if any; skipped if the base is not above it
+    void operator()(const datapoint_t& data, const datapoint_t& base)
+    {
+        if (percents_t pcts; _floor.percents(data, base, pcts)) {
+            (*this)(pcts);
+        }
+    }
+
+    /// Percent samples dropped for a zero base
+    std::size_t skipped() const noexcept
+    {
+        return _floor._skipped;
+    }
+
+    /// Subtract @param value, @see counters::calibrate(), from datapoints
+    void subtract(const datapoint_t& value)
+    {
+        _floor.subtract(value);
+    }
+
+    void clear() noexcept
+    {
+        for (auto& stat : _stats) {
+            stat.clear();
+        }
+        _floor._skipped = 0;
+    }
+
+    /// (name, value) pairs for a reporter, @see lpt::stats::interval_dataset
+    template <typename FIELDS>
+    void fields(FIELDS& out) const
+    {
+        for (size_t i = 0; i < percents_t::size(); ++i) {
+            _stats[i].fields(out, std::string(percents_t::name(i)) + ".");
+        }
+    }
+
+    /// e.g. per thread sets
+    hdr_accumulator_set& operator+=(const hdr_accumulator_set& other)
+    {
+        for (size_t i = 0; i < percents_t::size(); ++i) {
+            _stats[i] += other._stats[i];
+        }
+        _floor._skipped += other._floor._skipped;
+        return *this;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const hdr_accumulator_set& dt)
+    {
+        os << dt._stats[0].count() << " samples\n"
+           << "Counter, min%, max%, mean%, stddev, p50%, p90%, p99%, p99.9%, p99.99%\n";
+        for (size_t i = 0; i < percents_t::size(); ++i) {
+            const auto& stat(dt._stats[i]);
+            os << percents_t::name(i)          << ", "
+               << stat.min()                   << ", "
+               << stat.max()                   << ", "
+               << stat.mean()                  << ", "
+               << std::sqrt(stat.variance())   << ", "
+               << stat.percentile(50)          << ", "
+               << stat.percentile(90)          << ", "
+               << stat.percentile(99)          << ", "
+               << stat.percentile(99.9)        << ", "
+               << stat.percentile(99.99)
+               << '\n';
+        }
+
+        return os << dt._floor;
+    }
 
+    accumulator_set_t    _stats[percents_t::size()];
+    measurement_floor<counters_t> _floor;
+};
+
+/**
+ * Raw datapoints to a sample_log: a column per counter, then the elapsed
+ * time.
+ *
+\code
+
+   lpt::papi::sample_log<counters> log("moves.lsmp");
+   log(moveConstructRead);
+
+\endcode
+ */
+template<typename PAPI_COUNTERS> 
+class sample_log 
+{  
+public:
+
+    using counters_t  = PAPI_COUNTERS;
+    using datapoint_t = typename counters_t::datapoint;
+
+    explicit sample_log(const std::string& path)
+        : _log(path, columns())
+    {}
+
+    void operator()(const datapoint_t& data)
+    {
+        std::array<double, counters_t::size() + 1> row;
+        for (size_t i = 0; i < counters_t::size(); ++i) {
+            row[i] = static_cast<double>(data.values()[i]);
+        }
+        row[counters_t::size()] = static_cast<double>(data.elapsed_time().count());
+        _log(row);
+    }
+
+    void flush()
+    {
+        _log.flush();
+    }
+
+private:
+
+    static std::vector<std::string> columns()
+    {
+        std::vector<std::string> names;
+        for (size_t i = 0; i < counters_t::size(); ++i) {
+            names.push_back(counters_t::name(i));
+        }
+        names.push_back(lpt::chrono::timepoint::name());
+        return names;
+    }
+
+    lpt::stats::sample_log::writer _log;
+};
+
+} // namespace lpt::papi
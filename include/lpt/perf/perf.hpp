@@ -0,0 +1,587 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under LGPL 3.0 or later.
+ *
+ *  \brief CPU counters via Linux perf_event_open(2): no PAPI, no root; Linux, C++20
+ *
+ *  Same surface as lpt::papi::counters. Counts user space only, for the
+ *  calling thread: works with /proc/sys/kernel/perf_event_paranoid <= 2.
+ *  Hardware events that cannot be opened, e.g. in a VM without a virtual
+ *  PMU, fall back to the nearest software event; name() tells which.
+ *
+ *  Context switches and migrations happen in the kernel: user space only,
+ *  they would always read 0. They are counted kernel side, which needs
+ *  perf_event_paranoid <= 1 (or CAP_PERFMON); else counters throws.
+ */
+
+#ifndef INCLUDED_perf_hpp_6f1c3a85_e27d_4b90_a4d8_93b05e7c21f6
+#define INCLUDED_perf_hpp_6f1c3a85_e27d_4b90_a4d8_93b05e7c21f6
+
+#pragma once
+
+#include <lpt/chrono.hpp>
+
+#include <array>
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace lpt::perf
+{
+
+class error : public std::runtime_error
+{
+public:
+
+    /// @param paranoid: the highest perf_event_paranoid that allows it
+    error(const std::string& msg, int err, int paranoid = 2)
+        : std::runtime_error(msg + ": " + std::strerror(err)
+                             + (err == EACCES || err == EPERM
+                                ? " (needs /proc/sys/kernel/perf_event_paranoid <= " + std::to_string(paranoid) + ")" : ""))
+        , _err(err)
+    { }
+
+    int code() const noexcept { return _err; }
+
+private:
+
+    int _err;
+
+}; // error
+
+
+enum class event : int
+{
+    // hardware
+    cpu_cycles,
+    ref_cycles,
+    instructions,
+    stalled_cycles_frontend,
+    stalled_cycles_backend,
+    cache_references,
+    cache_misses,
+    l1d_read_misses,
+    llc_read_misses,
+    dtlb_read_misses,
+    branch_instructions,
+    branch_misses,
+
+    // software
+    task_clock,         // ns on cpu
+    context_switches,
+    cpu_migrations,
+    page_faults,
+    minor_faults,
+    major_faults,
+};
+
+namespace detail {
+
+struct event_info
+{
+    std::uint32_t _type;
+    std::uint64_t _config;
+    const char*   _name;
+    event         _fallback;   // if there is no PMU for it
+    bool          _kernel;     // fires in kernel context: 0 if user space only
+};
+
+constexpr std::uint64_t cache_read_miss(std::uint64_t cache) noexcept
+{
+    return cache
+         | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+         | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+constexpr event_info info(event e) noexcept
+{
+    switch (e) {
+    case event::cpu_cycles:              return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,              "cpu-cycles",              event::task_clock,        false};
+    case event::ref_cycles:              return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_REF_CPU_CYCLES,          "ref-cycles",              event::task_clock,        false};
+    case event::instructions:            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS,            "instructions",            event::task_clock,        false};
+    case event::stalled_cycles_frontend: return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND, "stalled-cycles-frontend", event::task_clock,        false};
+    case event::stalled_cycles_backend:  return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_STALLED_CYCLES_BACKEND,  "stalled-cycles-backend",  event::task_clock,        false};
+    case event::cache_references:        return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES,        "cache-references",        event::page_faults,       false};
+    case event::cache_misses:            return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,            "cache-misses",            event::page_faults,       false};
+    case event::l1d_read_misses:         return {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_L1D),  "L1-dcache-load-misses", event::page_faults,       false};
+    case event::llc_read_misses:         return {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_LL),   "LLC-load-misses",       event::page_faults,       false};
+    case event::dtlb_read_misses:        return {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_DTLB), "dTLB-load-misses",      event::page_faults,       false};
+    case event::branch_instructions:     return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS,     "branch-instructions",     event::task_clock,        false};
+    case event::branch_misses:           return {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES,           "branch-misses",           event::task_clock,        false};
+    case event::task_clock:              return {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK,              "task-clock",              event::task_clock,        false};
+    case event::context_switches:        return {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES,        "context-switches",        event::context_switches,  true};
+    case event::cpu_migrations:          return {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS,          "cpu-migrations",          event::cpu_migrations,    true};
+    case event::page_faults:             return {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS,             "page-faults",             event::page_faults,       false};
+    case event::minor_faults:            return {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MIN,         "minor-faults",            event::minor_faults,      false};
+    case event::major_faults:            return {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MAJ,         "major-faults",            event::major_faults,      false};
+    }
+    return {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_DUMMY, "dummy", event::task_clock, false};
+}
+
+/// For the calling thread, user space only but for kernel events; -1 and errno on failure
+inline int open(event e, int groupFd) noexcept
+{
+    const event_info ei(info(e));
+
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = ei._type;
+    attr.config         = ei._config;
+    attr.disabled       = groupFd == -1;   // the leader starts the group
+    attr.exclude_kernel = ! ei._kernel;
+    attr.exclude_hv     = 1;
+    attr.read_format    = PERF_FORMAT_GROUP
+                        | PERF_FORMAT_TOTAL_TIME_ENABLED
+                        | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0 /*this thread*/, -1 /*any cpu*/, groupFd, 0));
+}
+
+/// No PMU, or not this event: fall back
+inline bool unsupported(int err) noexcept
+{
+    return err == ENOENT || err == ENODEV || err == EOPNOTSUPP || err == EINVAL;
+}
+
+} // namespace detail
+
+
+/*
+ * Counters of the calling thread. Take datapoints and measurements on
+ * the thread that created the counters. If the kernel multiplexes the
+ * hardware counters, values are scaled by time enabled / time running.
+ */
+template <event... EVENTS>
+class counters
+{
+public:
+
+    static constexpr const size_t NUM_COUNTERS = sizeof...(EVENTS);
+    using event_t        = event;
+    using events_t       = std::array<event_t, NUM_COUNTERS>;
+    using names_t        = std::array<std::string, NUM_COUNTERS>;
+    using value_t        = long long;
+    using values_t       = std::array<value_t, NUM_COUNTERS>;
+    using eol_functor_t  = std::function<void(const counters&)>; // called in destructor
+
+    static_assert(NUM_COUNTERS > 0);
+
+    /**
+     *  @code
+     *  using counters = lpt::perf::counters<lpt::perf::event::instructions,
+     *                                       lpt::perf::event::cache_misses>;
+     *  counters scopedCtrs(
+     *     "some data",
+     *     [](const counters& ctrs){
+     *          std::cout << ctrs << std::endl;
+     *     });
+     *  @endcode
+     */
+    counters(std::string   tag     = {},
+             eol_functor_t eolFunc = noop)
+        : _tag(std::move(tag))
+        , _eolFunc(std::move(eolFunc))
+    {
+        _fds.fill(-1);
+        for (size_t i = 0; i < size(); ++i) {
+            _fds[i] = detail::open(opened()[i], _fds[0]);
+            if (_fds[i] == -1) {
+                const int err(errno);
+                close();
+                throw error(std::string("perf_event_open ") + detail::info(opened()[i])._name, err, detail::info(opened()[i])._kernel ? 1 : 2);
+            }
+        }
+        ::ioctl(_fds[0], PERF_EVENT_IOC_RESET,  PERF_IOC_FLAG_GROUP);
+        ::ioctl(_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+
+    ~counters()
+    {
+        close();
+        _eolFunc(*this);
+    }
+
+    counters(const counters&)            = delete;
+    counters& operator=(const counters&) = delete;
+    counters(counters&&)                 = delete;
+    counters& operator=(counters&&)      = delete;
+
+    static constexpr size_t  size() { return NUM_COUNTERS; }
+
+    const     events_t&    events()   const { return _events; }
+    const     values_t&    values()   const { return _accumulators; }
+    const     std::string& tag()      const { return _tag; }
+
+    /// The events counted: EVENTS, or their software fallbacks
+    static const events_t& opened()
+    {
+        static const events_t _opened = [](){
+            events_t evts(_events);
+            for (auto& e : evts) {
+                const int fd(detail::open(e, -1));
+                if (fd != -1) {
+                    ::close(fd);
+                    continue;
+                }
+                const int err(errno);
+                if ( ! detail::unsupported(err)) {
+                    throw error(std::string("perf_event_open ") + detail::info(e)._name, err, detail::info(e)._kernel ? 1 : 2);
+                }
+                e = detail::info(e)._fallback;
+            }
+            return evts;
+        }();
+        return _opened;
+    }
+
+    /// Do all hardware events have a PMU?
+    static bool hardware()
+    {
+        return opened() == _events;
+    }
+
+    static std::string name(size_t idx)
+    {
+        static const names_t _names = [&](){
+            names_t ns2;
+            for (size_t i = 0; i < size(); ++i) {
+                ns2[i] = detail::info(opened()[i])._name;
+                if (opened()[i] != _events[i]) {
+                    ns2[i] += std::string("(for ") + detail::info(_events[i])._name + ")";
+                }
+            }
+            return ns2;
+        }();
+
+        assert(idx < size());
+        return _names[idx];
+    }
+
+    /// Current totals, one syscall for the group
+    values_t read() const
+    {
+        struct
+        {
+            std::uint64_t _nr;
+            std::uint64_t _enabled;
+            std::uint64_t _running;
+            std::uint64_t _values[NUM_COUNTERS];
+        } group;
+
+        if (::read(_fds[0], &group, sizeof(group)) != static_cast<ssize_t>(sizeof(group))) {
+            throw error("perf read", errno);
+        }
+
+        values_t vals{0};
+        if (group._running == 0) {
+            return vals;   // never scheduled
+        }
+        const double scale(group._running < group._enabled
+                           ? static_cast<double>(group._enabled) / static_cast<double>(group._running)
+                           : 1.0);
+        for (size_t i = 0; i < size(); ++i) {
+            vals[i] = static_cast<value_t>(static_cast<double>(group._values[i]) * scale);
+        }
+        return vals;
+    }
+
+    void accumulate(const values_t& vals)
+    {
+        for (size_t i = 0; i < size(); ++i )
+        {
+            _accumulators[i] += vals[i];
+        }
+    }
+
+    std::ostream& print(std::ostream& os) const
+    {
+        if ( ! _tag.empty())
+        {
+            os << _tag << ": \n";
+        }
+        for (size_t i = 0; i < size(); ++i )
+        {
+            os << name(i) << ": " << _accumulators[i] << '\n';
+        }
+
+        return os;
+    }
+
+    friend inline std::ostream& operator<<(std::ostream&   os,
+                                           const counters& ctrs)
+    {
+        return ctrs.print(os);
+    }
+
+    // Do nothing functor
+    static void noop(const counters&) noexcept {}
+
+
+    using percent_t      = double;
+
+
+    struct datapoint
+    {
+        std::string                         _tag;
+        values_t                            _values{0};
+        lpt::chrono::timepoint::duration_t  _elapsedTime{0};
+
+        // FIXME: array is not really meant to be inheritable
+        struct percents : public std::array<percent_t, counters::size() + 1/*_elapsedTime*/>
+        {
+            using std::array<percent_t, NUM_COUNTERS + 1/*_elapsedTime*/>::array;
+
+            static constexpr const size_t POS_TIME = NUM_COUNTERS; // last entry in the array is for time
+
+            static constexpr size_t size() { return NUM_COUNTERS + 1; }
+
+            static std::string name(size_t idx)
+            {
+                assert(idx < size());
+                static const std::string timeLabel = "ElapsedTime(" + lpt::chrono::timepoint::unit() + ")";
+                return idx < counters::size() ? counters::name(idx) : timeLabel;
+            }
+
+            std::ostream& print(std::ostream& os) const
+            {
+                for (size_t i = 0; i < size(); ++i )
+                {
+                    os << name(i) << ": " << this->at(i) << " % \n";
+                }
+
+                os << std::endl;
+
+                return os;
+            }
+
+            friend inline std::ostream& operator<<(std::ostream&   os,
+                                                   const percents& pcts)
+            {
+                return pcts.print(os);
+            }
+        }; //percents
+
+        datapoint(const std::string& tag,
+                  const values_t&    values)
+            : _tag(tag)
+            , _values(values)
+        { }
+
+        datapoint(std::string tag)
+            : _tag(std::move(tag))
+        { }
+
+        datapoint()                            = default;
+        datapoint(const datapoint&)            = default;
+        datapoint& operator=(const datapoint&) = default;
+        datapoint(datapoint&&)                 = default;
+        datapoint& operator=(datapoint&&)      = default;
+
+        constexpr size_t       size()   const { return counters::size(); }
+        const     values_t&    values() const { return _values; }
+        const     std::string& tag()    const { return _tag; }
+        constexpr lpt::chrono::timepoint::duration_t  elapsed_time() const { return _elapsedTime; }
+
+        datapoint operator-(const datapoint& r) const
+        {
+            datapoint ret;
+            for (size_t i = 0; i < size(); ++i )
+            {
+                ret._values[i] = _values[i] - r._values[i];
+            }
+
+            ret._elapsedTime = _elapsedTime - r._elapsedTime;
+
+            return ret;
+        }
+
+        /// Less the measurement @param floor, @see counters::calibrate(); clamped to 0
+        datapoint less(const datapoint& floor) const
+        {
+            datapoint ret(*this);
+            for (size_t i = 0; i < size(); ++i )
+            {
+                ret._values[i] = std::max<value_t>(_values[i] - floor._values[i], 0);
+            }
+
+            ret._elapsedTime = std::max(_elapsedTime - floor._elapsedTime, lpt::chrono::timepoint::duration_t::zero());
+
+            return ret;
+        }
+
+        percents as_percent_of(const datapoint& base) const
+        {
+            percents pcts;
+            for (size_t i = 0; i < size(); ++i )
+            {
+                percent_t dataPoint(_values[i]);
+                percent_t basePoint(base._values[i]);
+                pcts[i] = basePoint != 0
+                        ? (((dataPoint - basePoint)/basePoint) * 100.0)
+                        : 0 ;
+            }
+
+            percent_t dataPoint(_elapsedTime.count());
+            percent_t basePoint(base._elapsedTime.count());
+            pcts[percents::POS_TIME] = basePoint != 0
+                                     ? (((dataPoint - basePoint)/basePoint) * 100.0)
+                                     : 0 ;
+
+            return pcts;
+        }
+
+        std::ostream& print(std::ostream& os) const
+        {
+            if ( ! _tag.empty())
+            {
+                os << _tag << ": \n";
+            }
+            for (size_t i = 0; i < NUM_COUNTERS; ++i )
+            {
+                os << counters::name(i) << ": " << _values[i] << '\n';
+            }
+
+            os << percents::name(percents::POS_TIME) << ": " << _elapsedTime.count() << '\n';
+
+            os << std::endl;
+
+            return os;
+        }
+
+        friend inline std::ostream& operator<<(std::ostream&    os,
+                                               const datapoint& md)
+        {
+            return md.print(os);
+        }
+    }; // datapoint
+
+    template <typename FUNC>
+    class measurement : public datapoint
+    {
+    public:
+
+        /// Apply the @param eolFunc functor in the destructor
+        measurement(std::string      tag,
+                    counters&        ctrs,
+                    FUNC             eolFunc)
+            : datapoint{std::move(tag)}
+            , _counters(ctrs)
+            , _startTime(lpt::chrono::timepoint::clock_t::now())
+            , _eolFunc(std::move(eolFunc))
+        {
+            datapoint::_values = _counters.read();
+        }
+
+        ~measurement()
+        {
+            const values_t secondRead(_counters.read());
+            for (size_t i = 0; i < counters::size(); ++i )
+            {
+                datapoint::_values[i] = secondRead[i] - datapoint::_values[i];
+            }
+            _counters.accumulate(datapoint::_values);
+
+            datapoint::_elapsedTime = std::chrono::duration_cast<lpt::chrono::timepoint::duration_t>(lpt::chrono::timepoint::clock_t::now() - _startTime);
+
+            _eolFunc(this);
+        }
+
+        measurement(const measurement&)            = default;
+        measurement& operator=(const measurement&) = default;
+        measurement(measurement&&)                 = default;
+        measurement& operator=(measurement&&)      = default;
+
+        datapoint data() const
+        {
+            datapoint dnow{datapoint::_tag, _counters.read()};
+            for (size_t i = 0; i < counters::size(); ++i )
+            {
+                dnow._values[i] -= datapoint::_values[i];
+            }
+
+            dnow._elapsedTime = lpt::chrono::timepoint::clock_t::now() - _startTime;
+
+            return dnow;
+        }
+
+    private:
+
+        counters&                            _counters;
+        lpt::chrono::timepoint::timepoint_t  _startTime;
+        FUNC                                 _eolFunc;
+
+    }; // measurement
+
+    /**
+     * Per counter and elapsed time medians of @param runs measurements of
+     * an empty region, as lpt::papi::counters::calibrate().
+     */
+    datapoint calibrate(unsigned runs = 1001)
+    {
+        const values_t         accumulators(_accumulators);
+        std::vector<datapoint> samples;
+        samples.reserve(runs);
+        for (unsigned i = 0; i < runs; ++i) {
+            measurement m("", *this, [](auto&&) {});
+            samples.push_back(m.data());
+        }
+        _accumulators = accumulators;
+
+        datapoint floor("Measurement floor");
+        auto      median = [&samples](auto&& field) {
+            std::vector<decltype(field(samples[0]))> column;
+            for (const auto& s : samples) {
+                column.push_back(field(s));
+            }
+            std::nth_element(column.begin(), column.begin() + column.size() / 2, column.end());
+            return column[column.size() / 2];
+        };
+        for (size_t i = 0; i < size(); ++i) {
+            floor._values[i] = median([i](const datapoint& d) { return d._values[i]; });
+        }
+        floor._elapsedTime = median([](const datapoint& d) { return d._elapsedTime; });
+        return floor;
+    }
+
+private:
+
+    void close() noexcept
+    {
+        for (auto& fd : _fds) {
+            if (fd != -1) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+    }
+
+private:
+
+    static constexpr const events_t   _events{ EVENTS... };
+    const std::string                 _tag;
+    const eol_functor_t               _eolFunc{noop}; // called in destructor
+    std::array<int, NUM_COUNTERS>     _fds;           // [0]: group leader
+    values_t                          _accumulators{0};
+
+}; // counters
+
+} // namespace lpt::perf
+
+
+#endif //#define INCLUDED_perf_hpp_6f1c3a85_e27d_4b90_a4d8_93b05e7c21f6
@@ -0,0 +1,489 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  \brief Lock contention profiler: sampled wait/hold times per call site; Linux, C++20
+ *
+ *  Needs lpt::stack::call_stack, thus libbfd.
+ *
+ */
+
+#ifndef INCLUDED_profiled_mutex_hpp_4f8b2c17_a6e3_4d09_b1c5_83e9f07d2a6b
+#define INCLUDED_profiled_mutex_hpp_4f8b2c17_a6e3_4d09_b1c5_83e9f07d2a6b
+
+#pragma once
+
+#include <lpt/callstack/call_stack.hpp>
+#include <lpt/crc32.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <signal.h>
+#include <unistd.h>
+
+namespace lpt {
+
+/*
+ * Sampling, recording and reporting for profiled_mutex.
+ *
+ * \code
+ *     lpt::lock_profiler::sampling(64);               // 1 acquisition in 64
+ *     lpt::lock_profiler::report_at_exit();
+ *     lpt::lock_profiler::report_on_signal(SIGUSR2);
+ * \endcode
+ */
+namespace lock_profiler {
+
+/// Frames kept per call site; the innermost are profiled_mutex's own
+inline constexpr std::size_t stack_depth = 8;
+
+using stack_t = lpt::stack::call_stack<stack_depth>;
+
+/*
+ * Log2 buckets of nanoseconds. One writer, the owning thread; relaxed
+ * loads and stores so that a report can read while it writes.
+ */
+class histogram
+{
+public:
+
+    static constexpr std::size_t BUCKETS = 64;
+
+    void record(std::uint64_t ns) noexcept
+    {
+        bump(_buckets[std::bit_width(ns) % BUCKETS], 1);
+        bump(_count, 1);
+        bump(_total, ns);
+        if (ns > _max.load(std::memory_order_relaxed)) {
+            _max.store(ns, std::memory_order_relaxed);
+        }
+    }
+
+    void merge(const histogram& other) noexcept
+    {
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            bump(_buckets[i], other._buckets[i].load(std::memory_order_relaxed));
+        }
+        bump(_count, other._count.load(std::memory_order_relaxed));
+        bump(_total, other._total.load(std::memory_order_relaxed));
+        _max.store(std::max(_max.load(std::memory_order_relaxed), other._max.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+    }
+
+    void clear() noexcept
+    {
+        for (auto& b : _buckets) {
+            b.store(0, std::memory_order_relaxed);
+        }
+        _count.store(0, std::memory_order_relaxed);
+        _total.store(0, std::memory_order_relaxed);
+        _max.store(0, std::memory_order_relaxed);
+    }
+
+    std::uint64_t count() const noexcept { return _count.load(std::memory_order_relaxed); }
+    std::uint64_t total() const noexcept { return _total.load(std::memory_order_relaxed); }
+    std::uint64_t max() const noexcept   { return _max.load(std::memory_order_relaxed); }
+
+    /// Upper bound of the bucket holding @param pct percent of the samples
+    std::uint64_t percentile(double pct) const noexcept
+    {
+        const double target(count() * pct / 100);
+        double       seen(0);
+        for (std::size_t i = 0; i < BUCKETS; ++i) {
+            seen += _buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target && seen > 0) {
+                return i ? (std::uint64_t(1) << i) - 1 : 0;
+            }
+        }
+        return max();
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const histogram& h)
+    {
+        os << h.count() << ", " << h.total() << ", "
+           << h.percentile(50) << ", " << h.percentile(99) << ", " << h.max();
+        return os;
+    }
+
+private:
+
+    static void bump(std::atomic<std::uint64_t>& a, std::uint64_t n) noexcept
+    {
+        a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<std::uint64_t>, BUCKETS> _buckets{};
+    std::atomic<std::uint64_t>                      _count{0};
+    std::atomic<std::uint64_t>                      _total{0};
+    std::atomic<std::uint64_t>                      _max{0};
+};
+
+struct site_stats
+{
+    histogram _wait;
+    histogram _hold;
+};
+
+/*
+ * Per thread, fixed size, open addressed call site table. The owning
+ * thread inserts and records; reports read concurrently: a site is
+ * published by the release store of its key, after its stack.
+ */
+class thread_table
+{
+public:
+
+    static constexpr std::size_t CAPACITY = 256;
+
+    /// nullptr when full
+    site_stats* site(std::uint64_t key, const stack_t& stack) noexcept
+    {
+        for (std::size_t i = 0; i < CAPACITY; ++i) {
+            entry& e(_entries[(key + i) % CAPACITY]);
+            const std::uint64_t k(e._key.load(std::memory_order_relaxed));
+            if (k == key) {
+                return &e._stats;
+            }
+            if (k == 0) {
+                e._stack = stack;
+                e._key.store(key, std::memory_order_release);
+                return &e._stats;
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename FUNC>
+    void for_each(FUNC&& func) const
+    {
+        for (const auto& e : _entries) {
+            if (const std::uint64_t k = e._key.load(std::memory_order_acquire); k) {
+                func(k, e._stack, e._stats);
+            }
+        }
+    }
+
+    /// Add @param other's sites to this one's; those that do not fit are dropped
+    void merge(const thread_table& other) noexcept
+    {
+        other.for_each([this](std::uint64_t key, const stack_t& stack, const site_stats& stats) {
+            if (site_stats* s = site(key, stack); s) {
+                s->_wait.merge(stats._wait);
+                s->_hold.merge(stats._hold);
+            }
+        });
+    }
+
+    /// Not while the owning thread records
+    void clear() noexcept
+    {
+        for (auto& e : _entries) {
+            e._key.store(0, std::memory_order_relaxed);
+            e._stats._wait.clear();
+            e._stats._hold.clear();
+        }
+    }
+
+private:
+
+    struct entry
+    {
+        std::atomic<std::uint64_t> _key{0};
+        stack_t                    _stack;
+        site_stats                 _stats;
+    };
+
+    std::array<entry, CAPACITY> _entries;
+};
+
+class registry
+{
+public:
+
+    static registry& instance()
+    {
+        static registry r;
+        return r;
+    }
+
+    /*
+     * The calling thread's table. When the thread exits its sites are
+     * merged into the registry's own table and the table goes to the
+     * next new thread: tables are as many as the most threads alive at
+     * once.
+     */
+    thread_table& table()
+    {
+        thread_local const owner o(acquire());
+        return *o._table;
+    }
+
+    /// Call sites sorted by total wait time
+    void report(std::ostream& os)
+    {
+        struct merged
+        {
+            stack_t     _stack;
+            site_stats  _stats;
+        };
+        std::map<std::uint64_t, merged> sites;
+        {
+            const auto add([&sites](std::uint64_t key, const stack_t& stack, const site_stats& stats) {
+                auto& m(sites[key]);
+                m._stack = stack;
+                m._stats._wait.merge(stats._wait);
+                m._stats._hold.merge(stats._hold);
+            });
+            std::lock_guard<std::mutex> lock(_lock);
+            for (const auto& t : _tables) {
+                t->for_each(add);
+            }
+            _exited->for_each(add);
+        }
+
+        std::vector<const merged*> sorted;
+        for (const auto& [key, m] : sites) {
+            sorted.push_back(&m);
+        }
+        std::sort(sorted.begin(), sorted.end(), [](const merged* a, const merged* b) {
+            return a->_stats._wait.total() > b->_stats._wait.total();
+        });
+
+        os << "Lock contention, sampled, ns\n";
+        for (const merged* m : sorted) {
+            os << "wait: samples, total, p50, p99, max: " << m->_stats._wait << '\n'
+               << "hold: samples, total, p50, p99, max: " << m->_stats._hold << '\n'
+               << lpt::stack::call_stack_info<stack_t,
+                                              lpt::stack::basic_symbol_info,
+                                              lpt::stack::terse_formatter>(m->_stack)
+               << '\n';
+        }
+        os << std::flush;
+    }
+
+private:
+
+    registry() = default;
+
+    struct owner
+    {
+        ~owner()
+        {
+            registry::instance().retire(_table);
+        }
+
+        thread_table* _table;
+    };
+
+    thread_table* acquire()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if ( ! _retired.empty()) {
+            thread_table* t(_retired.back());
+            _retired.pop_back();
+            return t;
+        }
+        _tables.push_back(std::make_unique<thread_table>());
+        return _tables.back().get();
+    }
+
+    void retire(thread_table* t)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _exited->merge(*t);
+        t->clear();
+        _retired.push_back(t);
+    }
+
+    std::mutex                                  _lock;      // tables, reports
+    std::vector<std::unique_ptr<thread_table>>  _tables;
+    std::vector<thread_table*>                  _retired;   // cleared, of exited threads
+    std::unique_ptr<thread_table>               _exited{std::make_unique<thread_table>()};   // their sites
+};
+
+/// 0: off
+inline std::atomic<unsigned> g_period{0};
+
+/// Sample 1 acquisition in @param period per thread; 0 turns sampling off
+inline void sampling(unsigned period) noexcept
+{
+    g_period.store(period, std::memory_order_relaxed);
+}
+
+/// Count down the thread's acquisitions. Called only when sampling is on.
+inline bool sample() noexcept
+{
+    thread_local unsigned countdown(0);
+    if (countdown > 0) {
+        --countdown;
+        return false;
+    }
+    const unsigned period(g_period.load(std::memory_order_relaxed));
+    countdown = period ? period - 1 : 0;
+    return period != 0;
+}
+
+inline void report(std::ostream& os = std::cerr)
+{
+    registry::instance().report(os);
+}
+
+inline void report_at_exit()
+{
+    registry::instance();   // constructed before the handler runs, destroyed after
+    std::atexit([] { report(std::cerr); });
+}
+
+/*
+ * A handler may only write() to a pipe. A thread reads the pipe and
+ * writes the report to std::cerr.
+ */
+inline void report_on_signal(int signo)
+{
+    static int fds[2] = {-1, -1};
+    if (fds[0] < 0) {
+        if (::pipe(fds) != 0) {
+            return;
+        }
+        std::thread([] {
+            char c;
+            while (::read(fds[0], &c, 1) == 1) {
+                report(std::cerr);
+            }
+        }).detach();
+    }
+
+    struct sigaction sa{};
+    sa.sa_handler = [](int) {
+        const char c('r');
+        [[maybe_unused]] auto n = ::write(fds[1], &c, 1);
+    };
+    sa.sa_flags = SA_RESTART;
+    ::sigemptyset(&sa.sa_mask);
+    ::sigaction(signo, &sa, nullptr);
+}
+
+} // namespace lock_profiler
+
+
+/*
+ * Wraps a lock: std::mutex, lpt::spinlock, ... . While sampling is off,
+ * lock() and unlock() add one load and one predictable branch each.
+ * A sampled acquisition captures the call stack and records its wait
+ * and hold times in the calling thread's table.
+ *
+ * \code
+ *     lpt::profiled_mutex<std::mutex> mtx;
+ *     std::lock_guard<lpt::profiled_mutex<std::mutex>> lock(mtx);
+ * \endcode
+ */
+template <typename MUTEX_T>
+class profiled_mutex
+{
+public:
+
+    using mutex_t = MUTEX_T;
+
+    profiled_mutex()  = default;
+    ~profiled_mutex() = default;
+
+    profiled_mutex(const profiled_mutex&)            = delete;
+    profiled_mutex& operator=(const profiled_mutex&) = delete;
+    profiled_mutex(profiled_mutex&&)                 = delete;
+    profiled_mutex& operator=(profiled_mutex&&)      = delete;
+
+    void lock()
+    {
+        if (lock_profiler::g_period.load(std::memory_order_relaxed)) [[unlikely]] {
+            if (lock_profiler::sample()) {
+                lock_sampled();
+                return;
+            }
+        }
+        _mutex.lock();
+    }
+
+    bool try_lock()
+    {
+        return _mutex.try_lock();
+    }
+
+    void unlock()
+    {
+        if (_site) [[unlikely]] {
+            unlock_sampled();
+            return;
+        }
+        _mutex.unlock();
+    }
+
+    mutex_t& native() noexcept
+    {
+        return _mutex;
+    }
+
+private:
+
+    using clock_t = std::chrono::steady_clock;
+
+    static std::uint64_t ns(clock_t::duration d) noexcept
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    }
+
+    [[gnu::noinline]] void lock_sampled()
+    {
+        const lock_profiler::stack_t stack(true);
+        std::uint64_t                key(0);
+        for (const auto& frame : stack) {
+            const auto addr(frame.addr());
+            key = lpt::algo::crc32(&addr, sizeof(addr), key);
+        }
+        key |= key ? 0 : 1;   // 0 marks free table entries
+
+        auto* site(lock_profiler::registry::instance().table().site(key, stack));
+
+        const auto start(clock_t::now());
+        _mutex.lock();
+        _acquired = clock_t::now();
+
+        if (site) {
+            site->_wait.record(ns(_acquired - start));
+        }
+        _site = site;
+    }
+
+    [[gnu::noinline]] void unlock_sampled()
+    {
+        lock_profiler::site_stats* site(_site);
+        const auto                 held(clock_t::now() - _acquired);
+        _site = nullptr;
+        _mutex.unlock();
+        site->_hold.record(ns(held));
+    }
+
+private:
+
+    mutex_t                     _mutex;
+    lock_profiler::site_stats*  _site = nullptr;   // of the current owner if sampled
+    clock_t::time_point         _acquired;
+
+}; // profiled_mutex
+
+} //namespace lpt
+
+
+#endif //#define INCLUDED_profiled_mutex_hpp_4f8b2c17_a6e3_4d09_b1c5_83e9f07d2a6b
@@ -0,0 +1,169 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  \brief Reader-writer lock with distributed reader counters; Linux, C++20
+ *
+ */
+
+#ifndef INCLUDED_rw_lock_hpp_e3b7d15a_94c2_4f6e_a8d0_5c1f7b29e6a4
+#define INCLUDED_rw_lock_hpp_e3b7d15a_94c2_4f6e_a8d0_5c1f7b29e6a4
+
+#pragma once
+
+#include <lpt/adaptive_mutex.hpp>
+#include <lpt/cpu.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+namespace lpt {
+
+/*
+ * Readers count themselves in one of SLOTS padded counters, picked per
+ * thread, so that concurrent lock_shared() calls do not write the same
+ * cache line. A writer raises a flag then waits for every slot to drain.
+ *
+ * Writer preference: readers that see the flag back off and wait for it
+ * to drop, so a stream of readers cannot starve a writer. Writers queue
+ * on an adaptive_mutex; readers park on the flag (a futex).
+ *
+ * Writes cost O(SLOTS); meant for read-mostly data. A Relacy model of the
+ * protocol is in src/relacy/rw_lock_test.cpp.
+ *
+ * \code
+ *     lpt::rw_lock lck;
+ *     { std::shared_lock r(lck); ... }
+ *     { std::unique_lock w(lck); ... }
+ * \endcode
+ */
+template <std::size_t SLOTS = 64>
+class basic_rw_lock
+{
+public:
+
+    static_assert(SLOTS > 0);
+
+    basic_rw_lock()  = default;
+    ~basic_rw_lock() = default;
+
+    basic_rw_lock(const basic_rw_lock&)            = delete;
+    basic_rw_lock& operator=(const basic_rw_lock&) = delete;
+    basic_rw_lock(basic_rw_lock&&)                 = delete;
+    basic_rw_lock& operator=(basic_rw_lock&&)      = delete;
+
+    void lock_shared() noexcept
+    {
+        auto& readers(slot());
+        for (;;) {
+            // Dekker with lock(): count ourselves, then look for a writer
+            readers.fetch_add(1, std::memory_order_seq_cst);
+            if (_writer.load(std::memory_order_seq_cst) == 0) {
+                return;
+            }
+            readers.fetch_sub(1, std::memory_order_release);
+            _writer.wait(1, std::memory_order_acquire);
+        }
+    }
+
+    bool try_lock_shared() noexcept
+    {
+        auto& readers(slot());
+        readers.fetch_add(1, std::memory_order_seq_cst);
+        if (_writer.load(std::memory_order_seq_cst) == 0) {
+            return true;
+        }
+        readers.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+
+    /// On the thread that called lock_shared()
+    void unlock_shared() noexcept
+    {
+        slot().fetch_sub(1, std::memory_order_release);
+    }
+
+    void lock() noexcept
+    {
+        _writers.lock();
+        // Dekker with lock_shared(): raise the flag, then look for readers.
+        // Both sides seq_cst: an acquire load could pass the store.
+        _writer.store(1, std::memory_order_seq_cst);
+        for (auto& s : _slots) {
+            drain(s);
+        }
+    }
+
+    bool try_lock() noexcept
+    {
+        if ( ! _writers.try_lock()) {
+            return false;
+        }
+        _writer.store(1, std::memory_order_seq_cst);
+        for (auto& s : _slots) {
+            if (s._readers.load(std::memory_order_seq_cst) != 0) {
+                release();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void unlock() noexcept
+    {
+        release();
+    }
+
+private:
+
+    struct alignas(lpt::cpu::cache_line_size) slot_t
+    {
+        std::atomic<std::int32_t> _readers{0};
+    };
+
+    // Round robin: threads keep their slot for life
+    std::atomic<std::int32_t>& slot() noexcept
+    {
+        static std::atomic<std::size_t> nextSlot{0};
+        thread_local const std::size_t  idx(nextSlot.fetch_add(1, std::memory_order_relaxed) % SLOTS);
+        return _slots[idx]._readers;
+    }
+
+    // Readers are in for short: pause while it pays (never on one CPU), then yield
+    static void drain(const slot_t& s) noexcept
+    {
+        for (unsigned spins = 0; s._readers.load(std::memory_order_seq_cst) != 0; ++spins) {
+            if (spins < lpt::cpu::spin_budget()) {
+                lpt::cpu::relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void release() noexcept
+    {
+        _writer.store(0, std::memory_order_release);
+        _writer.notify_all();
+        _writers.unlock();
+    }
+
+private:
+
+    std::array<slot_t, SLOTS>                                      _slots;
+    alignas(lpt::cpu::cache_line_size) std::atomic<std::uint32_t> _writer{0};
+    adaptive_mutex                                                 _writers;
+
+}; // basic_rw_lock
+
+using rw_lock = basic_rw_lock<>;
+
+} //namespace lpt
+
+
+#endif //#define INCLUDED_rw_lock_hpp_e3b7d15a_94c2_4f6e_a8d0_5c1f7b29e6a4
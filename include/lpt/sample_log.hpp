@@ -0,0 +1,336 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under LGPL 3.0 or later.
+ *
+ *  \brief Binary, column oriented log of raw samples: writer, reader, logging dataset; C++20
+ *
+ *  Convert or summarize offline with src/stats/tools/samplelog.
+ */
+
+#ifndef INCLUDED_sample_log_hpp_e07b2c95_31fa_4d6c_9b48_d5a86e1f3027
+#define INCLUDED_sample_log_hpp_e07b2c95_31fa_4d6c_9b48_d5a86e1f3027
+
+#pragma once
+
+#include <lpt/stats.hpp>
+#include <lpt/varint.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace lpt::stats
+{
+
+/*
+ * File:  "LSMP", version, varint #columns, per column: varint length, name;
+ *        then blocks.
+ * Block: varint #rows, then per column: encoding, varint #bytes, bytes.
+ *
+ * Rows are buffered, a block of BLOCK_ROWS at a time, then encoded column
+ * by column: a column of integral values (e.g. nanoseconds, counters) as
+ * zigzag varints of the deltas between rows, usually 1-3 bytes a value;
+ * any other column as raw doubles, in host byte order.
+ */
+namespace sample_log {
+
+inline constexpr char          MAGIC[4]   = {'L', 'S', 'M', 'P'};
+inline constexpr std::uint8_t  VERSION    = 1;
+inline constexpr std::size_t   BLOCK_ROWS = 4096;
+
+enum class encoding : std::uint8_t
+{
+    delta_varint = 0,
+    raw_double   = 1,
+};
+
+/// Doubles of integral values up to 2^53 round trip through an int64
+inline bool integral(double v) noexcept
+{
+    return std::isfinite(v) && v == std::trunc(v) && std::fabs(v) <= 9007199254740992.0;
+}
+
+class writer
+{
+public:
+
+    /// Throws std::invalid_argument if @param columns is empty and
+    /// std::runtime_error if @param path cannot be created
+    writer(const std::string& path, std::vector<std::string> columns)
+        : _os(open(path, columns))
+        , _columns(columns.size())
+    {
+        std::string header(MAGIC, sizeof(MAGIC));
+        header.push_back(static_cast<char>(VERSION));
+        lpt::varint::put(header, columns.size());
+        for (const auto& name : columns) {
+            lpt::varint::put(header, name.size());
+            header += name;
+        }
+        _os.write(header.data(), static_cast<std::streamsize>(header.size()));
+        for (auto& c : _columns) {
+            c.reserve(BLOCK_ROWS);
+        }
+    }
+
+    ~writer()
+    {
+        flush();
+    }
+
+    writer(const writer&)            = delete;
+    writer& operator=(const writer&) = delete;
+    writer(writer&&)                 = default;
+
+    /// Flushes the rows buffered for the file it leaves
+    writer& operator=(writer&& other)
+    {
+        if (this != &other) {
+            flush();
+            _os      = std::move(other._os);
+            _columns = std::move(other._columns);
+            _block   = std::move(other._block);
+            _bytes   = std::move(other._bytes);
+        }
+        return *this;
+    }
+
+    std::size_t columns() const noexcept
+    {
+        return _columns.size();
+    }
+
+    /// One value per column
+    void operator()(std::span<const double> row)
+    {
+        for (std::size_t i = 0; i < _columns.size(); ++i) {
+            _columns[i].push_back(i < row.size() ? row[i] : 0);
+        }
+        if (_columns[0].size() == BLOCK_ROWS) [[unlikely]] {
+            write_block();
+        }
+    }
+
+    void operator()(double value)
+    {
+        (*this)(std::span<const double>(&value, 1));
+    }
+
+    /// Writes the rows buffered so far
+    void flush()
+    {
+        if ( ! _columns.empty() && ! _columns[0].empty()) {
+            write_block();
+        }
+        _os.flush();
+    }
+
+private:
+
+    static std::ofstream open(const std::string& path, const std::vector<std::string>& columns)
+    {
+        if (columns.empty()) {
+            throw std::invalid_argument("sample_log: no columns for " + path);
+        }
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        if ( ! os) {
+            throw std::runtime_error("sample_log: cannot create " + path);
+        }
+        return os;
+    }
+
+    void write_block()
+    {
+        _block.clear();
+        lpt::varint::put(_block, _columns[0].size());
+        for (auto& column : _columns) {
+            _bytes.clear();
+            bool ints(true);
+            for (const double v : column) {
+                if ( ! integral(v)) {
+                    ints = false;
+                    break;
+                }
+            }
+            if (ints) {
+                std::int64_t prev(0);
+                for (const double v : column) {
+                    const auto i(static_cast<std::int64_t>(v));
+                    lpt::varint::put(_bytes, lpt::varint::zigzag(i - prev));
+                    prev = i;
+                }
+            } else {
+                _bytes.resize(column.size() * sizeof(double));
+                std::memcpy(_bytes.data(), column.data(), _bytes.size());
+            }
+            _block.push_back(static_cast<char>(ints ? encoding::delta_varint : encoding::raw_double));
+            lpt::varint::put(_block, _bytes.size());
+            _block += _bytes;
+            column.clear();
+        }
+        _os.write(_block.data(), static_cast<std::streamsize>(_block.size()));
+    }
+
+private:
+
+    std::ofstream                     _os;
+    std::vector<std::vector<double>>  _columns;
+    std::string                       _block;   // reused
+    std::string                       _bytes;
+};
+
+class reader
+{
+public:
+
+    using columns_t = std::vector<std::vector<double>>;
+
+    /// Throws std::runtime_error if @param path is not a sample log
+    explicit reader(const std::string& path)
+        : _is(path, std::ios::binary)
+    {
+        char magic[sizeof(MAGIC)];
+        if ( ! _is.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("sample_log: not a sample log: " + path);
+        }
+        if (_is.get() != VERSION) {
+            throw std::runtime_error("sample_log: unknown version: " + path);
+        }
+        const auto n(lpt::varint::get(_is));
+        for (std::uint64_t i = 0; i < n; ++i) {
+            std::string name(lpt::varint::get(_is), '\0');
+            _is.read(name.data(), static_cast<std::streamsize>(name.size()));
+            _names.push_back(std::move(name));
+        }
+        if ( ! _is) {
+            throw std::runtime_error("sample_log: truncated header: " + path);
+        }
+    }
+
+    const std::vector<std::string>& names() const noexcept
+    {
+        return _names;
+    }
+
+    /// The next block, a vector per column; false at the end
+    bool read(columns_t& columns)
+    {
+        if (_is.peek() == std::char_traits<char>::eof()) {
+            return false;
+        }
+        const auto rows(lpt::varint::get(_is));
+        columns.resize(_names.size());
+        for (auto& column : columns) {
+            column.clear();
+            const auto enc(static_cast<encoding>(_is.get()));
+            _bytes.resize(lpt::varint::get(_is));
+            if ( ! _is.read(_bytes.data(), static_cast<std::streamsize>(_bytes.size()))) {
+                throw std::runtime_error("sample_log: truncated block");
+            }
+
+            std::string_view in(_bytes);
+            if (enc == encoding::delta_varint) {
+                std::int64_t prev(0);
+                for (std::uint64_t r = 0; r < rows; ++r) {
+                    prev += lpt::varint::unzigzag(lpt::varint::get(in));
+                    column.push_back(static_cast<double>(prev));
+                }
+            } else if (enc == encoding::raw_double && in.size() == rows * sizeof(double)) {
+                column.resize(rows);
+                std::memcpy(column.data(), in.data(), in.size());
+            } else {
+                throw std::runtime_error("sample_log: bad column encoding");
+            }
+        }
+        return true;
+    }
+
+    /// All the rest
+    columns_t read_all()
+    {
+        columns_t all(_names.size()), block;
+        while (read(block)) {
+            for (std::size_t i = 0; i < all.size(); ++i) {
+                all[i].insert(all[i].end(), block[i].begin(), block[i].end());
+            }
+        }
+        return all;
+    }
+
+private:
+
+    std::ifstream             _is;
+    std::vector<std::string>  _names;
+    std::string               _bytes;
+};
+
+} // namespace sample_log
+
+
+/**
+ * As dataset, also logging every sample to @param path, a one column
+ * sample_log named after the tag.
+ *
+\code
+
+   lpt::chrono::logged_dataset moves("Move ns", "moves.lsmp");
+
+\endcode
+ */
+struct logged_dataset
+{
+    using value_t = dataset::value_t;
+
+    struct logged_t
+    {
+        void operator()(const value_t& data)
+        {
+            _stats(data);
+            (*_log)(data);
+        }
+
+        dataset::dataset_t                   _stats;
+        std::unique_ptr<sample_log::writer>  _log;
+    };
+
+    using dataset_t = logged_t;
+
+    logged_dataset(const std::string& tag, const std::string& path)
+        : _tag(tag)
+        , _stats{{}, std::make_unique<sample_log::writer>(path, std::vector<std::string>{tag})}
+    {}
+
+    ~logged_dataset()                                = default;
+    logged_dataset(const logged_dataset&)            = delete;
+    logged_dataset& operator=(const logged_dataset&) = delete;
+    logged_dataset(logged_dataset&&)                 = default;
+    logged_dataset& operator=(logged_dataset&&)      = delete;
+
+    void operator()(const value_t& data)
+    {
+        _stats(data);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const logged_dataset& dt)
+    {
+        return dataset::print(os, dt._tag, dt._stats._stats);
+    }
+
+    const std::string _tag;
+    dataset_t         _stats;
+};
+
+} // namespace lpt::stats
+
+
+#endif //#define INCLUDED_sample_log_hpp_e07b2c95_31fa_4d6c_9b48_d5a86e1f3027
@@ -8,7 +8,14 @@
  * 
  */
  
+#include <lpt/cpu.hpp>
+
 #include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include <time.h>
 
@@ -55,4 +62,273 @@ private:
 
 };
 
+
+namespace detail {
+
+/*
+ * Waiters in the queue locks poll a flag the releasing thread writes
+ * directly, so the next owner must notice at once: pause while it pays
+ * (never on one CPU), then yield so that a preempted owner or successor
+ * gets to run when there are more threads than cores.
+ */
+class spin_wait
+{
+public:
+
+    void operator()() noexcept
+    {
+        if (_spins < lpt::cpu::spin_budget()) {
+            ++_spins;
+            lpt::cpu::relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+
+    unsigned _spins = 0;
+};
+
+/*
+ * Per thread cache of queue nodes for lock()/unlock() without a node
+ * argument. A thread needs one node per lock it holds at the same time.
+ */
+template <typename NODE>
+class node_cache
+{
+public:
+
+    static NODE* get()
+    {
+        auto& free(instance()._free);
+        if (free.empty()) {
+            return new NODE;
+        }
+        NODE* n(free.back().release());
+        free.pop_back();
+        return n;
+    }
+
+    static void put(NODE* n)
+    {
+        instance()._free.emplace_back(n);
+    }
+
+private:
+
+    static node_cache& instance()
+    {
+        thread_local node_cache cache;
+        return cache;
+    }
+
+    std::vector<std::unique_ptr<NODE>> _free;
+};
+
+} // namespace detail
+
+
+/*
+ * FIFO: tickets are served in order. Still one shared word to spin on.
+ */
+class ticket_spinlock
+{
+public:
+
+    ticket_spinlock()  = default;
+    ~ticket_spinlock() = default;
+
+    ticket_spinlock(const ticket_spinlock&)            = delete;
+    ticket_spinlock& operator=(const ticket_spinlock&) = delete;
+    ticket_spinlock(ticket_spinlock&&)                 = delete;
+    ticket_spinlock& operator=(ticket_spinlock&&)      = delete;
+
+    void lock() noexcept
+    {
+        const std::uint32_t ticket(_next.fetch_add(1, std::memory_order_relaxed));
+        detail::spin_wait   wait;
+        while (_serving.load(std::memory_order_acquire) != ticket) {
+            wait();
+        }
+    }
+
+    bool try_lock() noexcept
+    {
+        std::uint32_t serving(_serving.load(std::memory_order_relaxed));
+        return _next.compare_exchange_strong(serving, serving + 1, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept
+    {
+        _serving.store(_serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+
+    std::atomic<std::uint32_t> _next{0};
+    std::atomic<std::uint32_t> _serving{0};
+
+}; // ticket_spinlock
+
+
+/*
+ * Mellor-Crummey & Scott: FIFO; each waiter spins on its own node, so a
+ * release touches only the next waiter's cache line.
+ *
+ * \code
+ *     lpt::mcs_lock lck;
+ *     {
+ *         lpt::mcs_lock::guard g(lck);                 // node on the stack
+ *         ...
+ *     }
+ *     std::lock_guard<lpt::mcs_lock> g(lck);           // node from a per thread cache
+ * \endcode
+ */
+class mcs_lock
+{
+public:
+
+    struct alignas(lpt::cpu::cache_line_size) node
+    {
+        std::atomic<node*> _next{nullptr};
+        std::atomic<bool>  _locked{false};
+    };
+
+    class guard
+    {
+    public:
+
+        explicit guard(mcs_lock& lck) : _lock(lck) { _lock.lock(_node); }
+        ~guard()                                   { _lock.unlock(_node); }
+
+        guard(const guard&)            = delete;
+        guard& operator=(const guard&) = delete;
+
+    private:
+
+        mcs_lock& _lock;
+        node      _node;
+    };
+
+    mcs_lock()  = default;
+    ~mcs_lock() = default;
+
+    mcs_lock(const mcs_lock&)            = delete;
+    mcs_lock& operator=(const mcs_lock&) = delete;
+    mcs_lock(mcs_lock&&)                 = delete;
+    mcs_lock& operator=(mcs_lock&&)      = delete;
+
+    void lock(node& me) noexcept
+    {
+        me._next.store(nullptr, std::memory_order_relaxed);
+        me._locked.store(true, std::memory_order_relaxed);
+
+        node* pred(_tail.exchange(&me, std::memory_order_acq_rel));
+        if (pred) {
+            pred->_next.store(&me, std::memory_order_release);
+            detail::spin_wait wait;
+            while (me._locked.load(std::memory_order_acquire)) {
+                wait();
+            }
+        }
+    }
+
+    void unlock(node& me) noexcept
+    {
+        node* succ(me._next.load(std::memory_order_acquire));
+        if ( ! succ) {
+            node* expected(&me);
+            if (_tail.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed)) {
+                return;
+            }
+            // A successor swapped the tail but has not linked itself yet
+            detail::spin_wait wait;
+            while ( ! (succ = me._next.load(std::memory_order_acquire))) {
+                wait();
+            }
+        }
+        succ->_locked.store(false, std::memory_order_release);
+    }
+
+    void lock()
+    {
+        node* me(detail::node_cache<node>::get());
+        lock(*me);
+        _owner = me;
+    }
+
+    void unlock()
+    {
+        node* me(_owner);
+        unlock(*me);
+        detail::node_cache<node>::put(me);
+    }
+
+private:
+
+    alignas(lpt::cpu::cache_line_size) std::atomic<node*> _tail{nullptr};
+    node*                                                 _owner = nullptr;   // lock()/unlock() only
+
+}; // mcs_lock
+
+
+/*
+ * Craig, Landin & Hagersten: FIFO; each waiter spins on its
+ * predecessor's node. On release the owner leaves its node in the queue
+ * and takes its predecessor's.
+ */
+class clh_lock
+{
+public:
+
+    struct alignas(lpt::cpu::cache_line_size) node
+    {
+        std::atomic<bool> _locked{false};
+    };
+
+    clh_lock()
+        : _tail(new node)
+    {}
+
+    // Must be unlocked
+    ~clh_lock()
+    {
+        delete _tail.load(std::memory_order_relaxed);
+    }
+
+    clh_lock(const clh_lock&)            = delete;
+    clh_lock& operator=(const clh_lock&) = delete;
+    clh_lock(clh_lock&&)                 = delete;
+    clh_lock& operator=(clh_lock&&)      = delete;
+
+    void lock()
+    {
+        node* me(detail::node_cache<node>::get());
+        me->_locked.store(true, std::memory_order_relaxed);
+
+        node*             pred(_tail.exchange(me, std::memory_order_acq_rel));
+        detail::spin_wait wait;
+        while (pred->_locked.load(std::memory_order_acquire)) {
+            wait();
+        }
+        _owner = me;
+        _pred  = pred;
+    }
+
+    void unlock()
+    {
+        node* pred(_pred);
+        _owner->_locked.store(false, std::memory_order_release);
+        detail::node_cache<node>::put(pred);
+    }
+
+private:
+
+    alignas(lpt::cpu::cache_line_size) std::atomic<node*> _tail;
+    node*                                                 _owner = nullptr;
+    node*                                                 _pred  = nullptr;
+
+}; // clh_lock
+
 } //namespace
@@ -17,6 +17,7 @@
 #include <boost/accumulators/statistics/variance.hpp>
 
 #include <string>
+#include <vector>
 
 namespace lpt::stats
 {
@@ -52,10 +53,14 @@ struct dataset
 
     friend std::ostream& operator<<(std::ostream& os, const dataset& dt)
     {
-        const auto& stat(dt._stats);
+        return print(os, dt._tag, dt._stats);
+    }
+
+    static std::ostream& print(std::ostream& os, const std::string& tag, const dataset_t& stat)
+    {
         const auto  n(boost::accumulators::count(stat));
         os << "Name, samples, min%, max%, mean%, median%, stddev\n"
-           << dt._tag                           << ", "
+           << tag                               << ", "
 	   << n                                 << ", "
            << boost::accumulators::min(stat)    << ", "
            << boost::accumulators::max(stat)    << ", "
@@ -71,5 +76,49 @@ struct dataset
     dataset_t         _stats;
 };
 
+/**
+ * As dataset, keeping the samples too, e.g. for lpt::stats::compare().
+ */
+struct sample_dataset 
+{  
+    using value_t = dataset::value_t;
+
+    struct samples_t
+    {
+        void operator()(const value_t& data)
+        {
+            _stats(data);
+            _values.push_back(data);
+        }
+
+        dataset::dataset_t   _stats;
+        std::vector<value_t> _values;
+    };
+
+    using dataset_t = samples_t;
+
+    sample_dataset(const std::string& tag) : _tag(tag) {}
+
+    sample_dataset()                                 = default;
+    ~sample_dataset()                                = default;
+    sample_dataset(const sample_dataset&)            = default;
+    sample_dataset& operator=(const sample_dataset&) = default;
+    sample_dataset(sample_dataset&&)                 = default;
+    sample_dataset& operator=(sample_dataset&&)      = default;
+
+    void operator()(const value_t& data)
+    {
+        _stats(data);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const sample_dataset& dt)
+    {
+        return dataset::print(os, dt._tag, dt._stats._stats);
+    }
+
+    const std::string _tag;
+    dataset_t         _stats;
+};
+
 } // namespace lpt::stats
 
@@ -0,0 +1,312 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under LGPL 3.0 or later.
+ *
+ *  \brief A/B comparison of two datasets: Mann-Whitney U, bootstrap CI of the median ratio; C++20
+ */
+
+#ifndef INCLUDED_stats_compare_hpp_58c1a7e2_0b94_4d3f_8a6e_e27f3c91d045
+#define INCLUDED_stats_compare_hpp_58c1a7e2_0b94_4d3f_8a6e_e27f3c91d045
+
+#pragma once
+
+#include <lpt/hdr_histogram.hpp>
+#include <lpt/stats.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace lpt::stats
+{
+
+struct compare_options
+{
+    double        _trim       = 0;      // fraction of the samples dropped from each tail, [0, 0.5)
+    double        _confidence = 0.95;   // of the interval, and 1 - alpha of the test
+    unsigned      _resamples  = 2000;   // bootstrap
+    std::uint64_t _seed       = 1;
+};
+
+/*
+ * B against A. The median ratio and its interval are meant for positive
+ * data, e.g. durations.
+ */
+struct comparison
+{
+    std::uint64_t _countA     = 0;      // after trimming
+    std::uint64_t _countB     = 0;
+    double        _medianA    = 0;
+    double        _medianB    = 0;
+    double        _ratio      = 0;      // medianB / medianA
+    double        _ratioLow   = 0;      // bootstrap percentile interval
+    double        _ratioHigh  = 0;
+    double        _u          = 0;      // Mann-Whitney U of B
+    double        _z          = 0;      // normal approximation, tie corrected
+    double        _p          = 1;      // two sided
+    double        _confidence = 0.95;
+
+    /// The test rejects "same distribution" and the interval excludes 1
+    bool significant() const noexcept
+    {
+        return _p < 1 - _confidence && (_ratioLow > 1 || _ratioHigh < 1);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const comparison& c)
+    {
+        os << "samples A, samples B, median A, median B, B/A, B/A low, B/A high, U, z, p, verdict\n"
+           << c._countA    << ", "
+           << c._countB    << ", "
+           << c._medianA   << ", "
+           << c._medianB   << ", "
+           << c._ratio     << ", "
+           << c._ratioLow  << ", "
+           << c._ratioHigh << ", "
+           << c._u         << ", "
+           << c._z         << ", "
+           << c._p         << ", "
+           << (c.significant() ? "significant" : "noise")
+           << '\n';
+        return os;
+    }
+};
+
+namespace detail {
+
+/// Distinct values, ascending, with their counts
+struct bin
+{
+    double        _value;
+    std::uint64_t _count;
+};
+
+using bins_t = std::vector<bin>;
+
+inline bins_t to_bins(std::vector<double> values)
+{
+    std::sort(values.begin(), values.end());
+    bins_t bins;
+    for (const double v : values) {
+        if (bins.empty() || bins.back()._value != v) {
+            bins.push_back({v, 0});
+        }
+        ++bins.back()._count;
+    }
+    return bins;
+}
+
+/// Bucket midpoints
+template <unsigned PRECISION_BITS>
+bins_t to_bins(const hdr_accumulator<PRECISION_BITS>& acc)
+{
+    using histogram_t = typename hdr_accumulator<PRECISION_BITS>::histogram_t;
+
+    auto mid = [&acc](std::size_t idx, double sign) {
+        const double m((static_cast<double>(histogram_t::lowest(idx)) + static_cast<double>(histogram_t::highest(idx))) / 2);
+        return std::clamp(sign * m * acc.unit(), acc.min(), acc.max());
+    };
+
+    bins_t bins;
+    for (std::size_t i = histogram_t::BUCKETS; i-- > 0; ) {
+        if (const auto n = acc.negative().count(i); n) {
+            bins.push_back({mid(i, -1), n});
+        }
+    }
+    for (std::size_t i = 0; i < histogram_t::BUCKETS; ++i) {
+        if (const auto n = acc.positive().count(i); n) {
+            bins.push_back({mid(i, 1), n});
+        }
+    }
+    return bins;
+}
+
+inline std::uint64_t total(const bins_t& bins) noexcept
+{
+    std::uint64_t n(0);
+    for (const auto& b : bins) {
+        n += b._count;
+    }
+    return n;
+}
+
+/// Drop @param fraction of the samples from each tail
+inline void trim(bins_t& bins, double fraction)
+{
+    auto cut = [](auto first, auto last, std::uint64_t n) {
+        for (; first != last && n; ++first) {
+            const std::uint64_t k(std::min(n, first->_count));
+            first->_count -= k;
+            n             -= k;
+        }
+    };
+    const auto n(static_cast<std::uint64_t>(std::floor(static_cast<double>(total(bins)) * fraction)));
+    cut(bins.begin(), bins.end(), n);
+    cut(bins.rbegin(), bins.rend(), n);
+    std::erase_if(bins, [](const bin& b) { return b._count == 0; });
+}
+
+/// 1-based
+inline double value_at_rank(const bins_t& bins, std::uint64_t rank) noexcept
+{
+    std::uint64_t seen(0);
+    for (const auto& b : bins) {
+        seen += b._count;
+        if (seen >= rank) {
+            return b._value;
+        }
+    }
+    return bins.empty() ? 0 : bins.back()._value;
+}
+
+inline double median(const bins_t& bins) noexcept
+{
+    const std::uint64_t n(total(bins));
+    if (n == 0) {
+        return 0;
+    }
+    return n % 2 ? value_at_rank(bins, n / 2 + 1)
+                 : (value_at_rank(bins, n / 2) + value_at_rank(bins, n / 2 + 1)) / 2;
+}
+
+/// Draw total(from) samples with replacement, as counts: conditional binomials
+inline void resample(const bins_t& from, bins_t& to, std::mt19937_64& rng)
+{
+    to = from;
+    std::uint64_t left(total(from));
+    std::uint64_t mass(left);
+    for (auto& b : to) {
+        const std::uint64_t weight(b._count);
+        if (left == 0 || weight == mass) {
+            b._count = left;
+        } else {
+            std::binomial_distribution<std::uint64_t> draw(left, static_cast<double>(weight) / static_cast<double>(mass));
+            b._count = draw(rng);
+        }
+        left -= b._count;
+        mass -= weight;
+    }
+}
+
+/// U of @param b, tie corrected z
+inline void mann_whitney(const bins_t& a, const bins_t& b, comparison& c)
+{
+    const double na(static_cast<double>(total(a)));
+    const double nb(static_cast<double>(total(b)));
+    const double n(na + nb);
+
+    double rankSumB(0), ties(0), below(0);
+    for (std::size_t i = 0, j = 0; i < a.size() || j < b.size(); ) {
+        const double value(j == b.size() || (i < a.size() && a[i]._value < b[j]._value) ? a[i]._value : b[j]._value);
+        double inA(0), inB(0);
+        if (i < a.size() && a[i]._value == value) {
+            inA = static_cast<double>(a[i++]._count);
+        }
+        if (j < b.size() && b[j]._value == value) {
+            inB = static_cast<double>(b[j++]._count);
+        }
+        const double t(inA + inB);
+        rankSumB += inB * (below + (t + 1) / 2);
+        ties     += t * t * t - t;
+        below    += t;
+    }
+
+    c._u = rankSumB - nb * (nb + 1) / 2;
+    const double mean(na * nb / 2);
+    const double var(na * nb / 12 * ((n + 1) - ties / (n * (n - 1))));
+    if (var > 0) {
+        const double d(c._u - mean);
+        c._z = (d - std::copysign(std::min(0.5, std::fabs(d)), d)) / std::sqrt(var);
+        c._p = std::erfc(std::fabs(c._z) / std::sqrt(2.0));
+    }
+}
+
+inline comparison compare(bins_t a, bins_t b, const compare_options& opts)
+{
+    if ( ! (opts._trim >= 0 && opts._trim < 0.5)) {
+        throw std::invalid_argument("compare: trim not in [0, 0.5)");
+    }
+    trim(a, opts._trim);
+    trim(b, opts._trim);
+
+    comparison c;
+    c._confidence = opts._confidence;
+    c._countA     = total(a);
+    c._countB     = total(b);
+    if (c._countA == 0 || c._countB == 0) {
+        return c;
+    }
+    c._medianA = median(a);
+    c._medianB = median(b);
+    c._ratio   = c._medianB / c._medianA;
+
+    mann_whitney(a, b, c);
+
+    std::mt19937_64    rng(opts._seed);
+    std::vector<double> ratios;
+    ratios.reserve(opts._resamples);
+    bins_t ra, rb;
+    for (unsigned i = 0; i < opts._resamples; ++i) {
+        resample(a, ra, rng);
+        resample(b, rb, rng);
+        if (const double ma = median(ra); ma != 0) {
+            ratios.push_back(median(rb) / ma);
+        }
+    }
+    if ( ! ratios.empty()) {
+        std::sort(ratios.begin(), ratios.end());
+        const double tail((1 - opts._confidence) / 2);
+        auto at = [&ratios](double q) {
+            const auto idx(static_cast<std::size_t>(q * static_cast<double>(ratios.size() - 1) + 0.5));
+            return ratios[std::min(idx, ratios.size() - 1)];
+        };
+        c._ratioLow  = at(tail);
+        c._ratioHigh = at(1 - tail);
+    }
+    return c;
+}
+
+inline bins_t to_bins(const sample_dataset& dt)
+{
+    return to_bins(dt._stats._values);
+}
+
+template <unsigned PRECISION_BITS>
+bins_t to_bins(const hdr_dataset<PRECISION_BITS>& dt)
+{
+    return to_bins(dt._stats);
+}
+
+} // namespace detail
+
+
+/**
+ * Is B different from A, or is it noise? A and B: the raw samples, as
+ * std::vector<double> or sample_dataset, or histograms, as hdr_dataset
+ * or hdr_accumulator (values are bucket midpoints). Also takes the
+ * lpt::chrono variants.
+ *
+\code
+
+   lpt::chrono::sample_dataset copies("Copy"), moves("Move");
+   ...
+   std::cout << lpt::stats::compare(copies, moves, {._trim = 0.05});
+
+\endcode
+ */
+template <typename A, typename B>
+comparison compare(const A& a, const B& b, const compare_options& opts = {})
+{
+    return detail::compare(detail::to_bins(a), detail::to_bins(b), opts);
+}
+
+} // namespace lpt::stats
+
+
+#endif //#define INCLUDED_stats_compare_hpp_58c1a7e2_0b94_4d3f_8a6e_e27f3c91d045
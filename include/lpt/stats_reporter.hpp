@@ -0,0 +1,450 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under LGPL 3.0 or later.
+ *
+ *  \brief Registry of stats and a periodic reporter thread writing rotated CSV/JSON; Linux, C++20
+ */
+
+#ifndef INCLUDED_stats_reporter_hpp_2c9f4a71_d863_4e0b_b5a2_7e16c04f98d3
+#define INCLUDED_stats_reporter_hpp_2c9f4a71_d863_4e0b_b5a2_7e16c04f98d3
+
+#pragma once
+
+#include <lpt/chrono.hpp>
+#include <lpt/hdr_histogram.hpp>
+#include <lpt/iostream.hpp>
+#include <lpt/spinlock.hpp>
+#include <lpt/thread_slots.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace lpt::stats
+{
+
+using field_t  = std::pair<std::string, double>;
+using fields_t = std::vector<field_t>;
+
+/*
+ * Named sources of interval stats. A source appends the (name, value)
+ * pairs of the interval since it was last collected, and starts a new
+ * interval.
+ */
+class registry
+{
+public:
+
+    using collect_t = std::function<void(fields_t&)>;
+
+    struct report_t
+    {
+        std::string _name;
+        fields_t    _fields;
+    };
+
+    static registry& instance()
+    {
+        static registry r;
+        return r;
+    }
+
+    std::uint64_t add(std::string name, collect_t collect)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _sources.emplace(++_lastId, source{std::move(name), std::move(collect)});
+        return _lastId;
+    }
+
+    /// Waits for a collection in progress
+    void remove(std::uint64_t id)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _sources.erase(id);
+    }
+
+    /// Every source, in registration order
+    std::vector<report_t> collect()
+    {
+        std::vector<report_t>       reports;
+        std::lock_guard<std::mutex> lock(_lock);
+        for (auto& [id, src] : _sources) {
+            reports.push_back({src._name, {}});
+            src._collect(reports.back()._fields);
+        }
+        return reports;
+    }
+
+private:
+
+    registry() = default;
+
+    struct source
+    {
+        std::string _name;
+        collect_t   _collect;
+    };
+
+    std::mutex                         _lock;    // sources; held while collecting
+    std::map<std::uint64_t, source>    _sources;
+    std::uint64_t                      _lastId = 0;
+};
+
+/// Unregisters in the destructor
+class registration
+{
+public:
+
+    registration() = default;
+
+    registration(std::string name, registry::collect_t collect)
+        : _id(registry::instance().add(std::move(name), std::move(collect)))
+    { }
+
+    ~registration()
+    {
+        if (_id) {
+            registry::instance().remove(_id);
+        }
+    }
+
+    registration(const registration&)            = delete;
+    registration& operator=(const registration&) = delete;
+
+    registration(registration&& other) noexcept
+        : _id(std::exchange(other._id, 0))
+    { }
+
+    registration& operator=(registration&& other) noexcept
+    {
+        if (this != &other) {
+            if (_id) {
+                registry::instance().remove(_id);
+            }
+            _id = std::exchange(other._id, 0);
+        }
+        return *this;
+    }
+
+private:
+
+    std::uint64_t _id = 0;
+};
+
+
+/*
+ * Self registered stats of many threads, reported per interval.
+ *
+ * STATS_T: mergeable (+=), clear()-able stats with fields(fields_t&),
+ * e.g. hdr_accumulator<>, lpt::papi::hdr_accumulator_set<>. Not
+ * lpt::stats::dataset: boost accumulators do not merge.
+ *
+ * Each thread records in its own pair of buffers, picked by an epoch.
+ * The reporter bumps the epoch, waits for records already under way in
+ * the previous buffers (at most one per thread), then merges and clears
+ * them. Recorders never wait: a record is a store, a load, the STATS_T
+ * update and a store; the first one of a thread registers its buffers.
+ *
+ \code
+    lpt::stats::interval_dataset<> latency("latency_ns");
+    // any thread
+    latency(ns);
+ \endcode
+ */
+template <typename STATS_T = hdr_accumulator<>>
+class interval_dataset
+{
+public:
+
+    using stats_t = STATS_T;
+
+    /// @param prototype: a clear STATS_T, e.g. with a unit
+    interval_dataset(std::string name, stats_t prototype = stats_t())
+        : _prototype(std::move(prototype))
+        , _registration(std::move(name), [this](fields_t& out) { collect(out); })
+    { }
+
+    ~interval_dataset() = default;
+
+    interval_dataset(const interval_dataset&)            = delete;
+    interval_dataset& operator=(const interval_dataset&) = delete;
+    interval_dataset(interval_dataset&&)                 = delete;
+    interval_dataset& operator=(interval_dataset&&)      = delete;
+
+    template <typename... ARGS>
+    void operator()(ARGS&&... args)
+    {
+        slot_t&             s(local());
+        const std::uint32_t seq(s._seq.load(std::memory_order_relaxed));
+
+        // Dekker with collect(): announce ourselves, then read the epoch
+        s._seq.store(seq + 1, std::memory_order_seq_cst);
+        const std::uint32_t epoch(_epoch.load(std::memory_order_seq_cst));
+        s._buffers[epoch & 1](std::forward<ARGS>(args)...);
+        s._seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /// Merge of the interval's buffers; starts a new interval
+    stats_t snapshot()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        const std::uint32_t previous(_epoch.load(std::memory_order_relaxed));
+        _epoch.store(previous + 1, std::memory_order_seq_cst);
+
+        stats_t total(_prototype);
+        for (auto& s : _slots) {
+            // A record that may have read the previous epoch
+            if (const std::uint32_t seq = s->_seq.load(std::memory_order_seq_cst); seq & 1) {
+                lpt::detail::spin_wait wait;
+                while (s->_seq.load(std::memory_order_acquire) == seq) {
+                    wait();
+                }
+            }
+            auto& buffer(s->_buffers[previous & 1]);
+            total += buffer;
+            buffer.clear();
+        }
+        return total;
+    }
+
+private:
+
+    struct alignas(lpt::cpu::cache_line_size) slot_t
+    {
+        explicit slot_t(const stats_t& prototype)
+            : _buffers{prototype, prototype}
+        { }
+
+        std::atomic<std::uint32_t> _seq{0};   // odd while recording
+        stats_t                    _buffers[2];
+    };
+
+    void collect(fields_t& out)
+    {
+        snapshot().fields(out);
+    }
+
+    slot_t& local()
+    {
+        return lpt::detail::thread_slot<slot_t>(_id, [this] {
+            std::lock_guard<std::mutex> lock(_lock);
+            _slots.push_back(std::make_unique<slot_t>(_prototype));
+            return _slots.back().get();
+        });
+    }
+
+private:
+
+    const lpt::detail::object_id          _id;
+    const stats_t                         _prototype;
+    std::atomic<std::uint32_t>            _epoch{0};
+    std::mutex                            _lock;    // slot registration and snapshots
+    std::vector<std::unique_ptr<slot_t>>  _slots;
+    registration                          _registration;   // last: unregisters first
+
+}; // interval_dataset
+
+
+/*
+ * Reports a concurrent_accumulator, by interval: its totals minus those
+ * of the previous report. Keep the registration for as long as @param acc
+ * lives.
+ */
+inline registration report(const lpt::chrono::concurrent_accumulator& acc)
+{
+    using totals_t = lpt::chrono::concurrent_accumulator::totals_t;
+
+    return registration(acc.tag(), [&acc, last = totals_t()](fields_t& out) mutable {
+        const totals_t now(acc.totals());   // one pass: elapsed and count of the same moment
+        const auto     elapsed(now._elapsed - last._elapsed);
+        const auto     count(now._count - last._count);
+        last = now;
+
+        out.emplace_back("count",   static_cast<double>(count));
+        out.emplace_back("elapsed", static_cast<double>(elapsed));
+        out.emplace_back("mean",    count ? static_cast<double>(elapsed) / static_cast<double>(count) : 0.0);
+    });
+}
+
+
+/*
+ * Every @param period, collects the registry and appends one line per
+ * source to @param path:
+ *
+ *     csv:  time,name,field,value        (one line per field)
+ *     json: {"time":...,"name":"...","field":value,...}
+ *
+ * time: seconds since the epoch. When the file reaches @param maxBytes
+ * it is renamed path.1 (path.1 to path.2, ...) and @param keep files are
+ * kept.
+ *
+ \code
+    lpt::stats::reporter rep(std::chrono::seconds(10), "stats.csv");
+ \endcode
+ */
+class reporter
+{
+public:
+
+    enum class format { csv, json };
+
+    reporter(std::chrono::milliseconds period,
+             std::string               path,
+             format                    fmt      = format::csv,
+             std::uintmax_t            maxBytes = 64 * 1024 * 1024,
+             unsigned                  keep     = 4)
+        : _period(period)
+        , _path(std::move(path))
+        , _format(fmt)
+        , _maxBytes(maxBytes)
+        , _keep(keep)
+    {
+        open();
+        _thread = std::thread([this] { run(); });
+    }
+
+    /// Reports a last time
+    ~reporter()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _stop = true;
+        }
+        _wakeup.notify_one();
+        _thread.join();
+        report();
+    }
+
+    reporter(const reporter&)            = delete;
+    reporter& operator=(const reporter&) = delete;
+    reporter(reporter&&)                 = delete;
+    reporter& operator=(reporter&&)      = delete;
+
+    /// Also called by the thread
+    void report()
+    {
+        const auto reports(registry::instance().collect());
+        const auto now(std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count());
+        char       time[32];
+        std::snprintf(time, sizeof(time), "%.3f", now);
+
+        std::lock_guard<std::mutex> lock(_fileLock);
+        for (const auto& r : reports) {
+            if (_format == format::csv) {
+                for (const auto& [field, value] : r._fields) {
+                    _os << time << ',';
+                    lpt::csv_quote(_os, r._name);
+                    _os << ',';
+                    lpt::csv_quote(_os, field);
+                    _os << ',' << value << '\n';
+                }
+            } else {
+                _os << "{\"time\":" << time << ",\"name\":\"";
+                json_escape(_os, r._name);
+                _os << '"';
+                for (const auto& [field, value] : r._fields) {
+                    _os << ",\"";
+                    json_escape(_os, field);
+                    _os << "\":" << (std::isfinite(value) ? value : 0);
+                }
+                _os << "}\n";
+            }
+        }
+        _os.flush();
+        rotate();
+    }
+
+private:
+
+    // As lpt::trace
+    static void json_escape(std::ostream& os, std::string_view str)
+    {
+        for (const char ch : str) {
+            const unsigned char c(static_cast<unsigned char>(ch));
+            if (c == '"' || c == '\\') {
+                os << '\\' << ch;
+            } else if (c < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                os << buf;
+            } else {
+                os << ch;
+            }
+        }
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        while ( ! _wakeup.wait_for(lock, _period, [this] { return _stop; })) {
+            lock.unlock();
+            report();
+            lock.lock();
+        }
+    }
+
+    void open()
+    {
+        _os.open(_path, std::ios::app);
+        if (_format == format::csv && _os.tellp() == 0) {
+            _os << "time,name,field,value\n";
+        }
+    }
+
+    void rotate()
+    {
+        std::error_code ec;
+        if (std::filesystem::file_size(_path, ec) < _maxBytes || ec) {
+            return;
+        }
+        _os.close();
+        for (unsigned i = _keep; i > 1; --i) {
+            std::filesystem::rename(_path + '.' + std::to_string(i - 1), _path + '.' + std::to_string(i), ec);
+        }
+        if (_keep) {
+            std::filesystem::rename(_path, _path + ".1", ec);
+        } else {
+            std::filesystem::remove(_path, ec);
+        }
+        open();
+    }
+
+private:
+
+    const std::chrono::milliseconds _period;
+    const std::string               _path;
+    const format                    _format;
+    const std::uintmax_t            _maxBytes;
+    const unsigned                  _keep;
+
+    std::mutex                      _fileLock;   // _os
+    std::ofstream                   _os;
+
+    std::mutex                      _lock;       // _stop
+    std::condition_variable         _wakeup;
+    bool                            _stop = false;
+    std::thread                     _thread;
+
+}; // reporter
+
+} // namespace lpt::stats
+
+
+#endif //#define INCLUDED_stats_reporter_hpp_2c9f4a71_d863_4e0b_b5a2_7e16c04f98d3
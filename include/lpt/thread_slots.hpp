@@ -0,0 +1,128 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  \brief Per thread slots of shared objects; C++20
+ *
+ */
+
+#ifndef INCLUDED_thread_slots_hpp_5c2e8a13_d7f4_4b69_9e01_a3b6f48c27d5
+#define INCLUDED_thread_slots_hpp_5c2e8a13_d7f4_4b69_9e01_a3b6f48c27d5
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace lpt::detail {
+
+/*
+ * Identity of an object that gives each thread its own slot: never
+ * reused, and alive until the owner is destroyed.
+ */
+class object_id
+{
+public:
+
+    object_id()
+        : _id(next())
+    {
+        std::lock_guard<std::mutex> lock(registry_lock());
+        registry().insert(_id);
+    }
+
+    ~object_id()
+    {
+        std::lock_guard<std::mutex> lock(registry_lock());
+        registry().erase(_id);
+    }
+
+    object_id(const object_id&)            = delete;
+    object_id& operator=(const object_id&) = delete;
+    object_id(object_id&&)                 = delete;
+    object_id& operator=(object_id&&)      = delete;
+
+    operator std::uint64_t() const noexcept
+    {
+        return _id;
+    }
+
+    /// Drop from @param slots the ids of destroyed objects
+    template <typename MAP>
+    static void prune(MAP& slots)
+    {
+        std::lock_guard<std::mutex> lock(registry_lock());
+        std::erase_if(slots, [](const auto& entry) { return ! registry().contains(entry.first); });
+    }
+
+private:
+
+    static std::uint64_t next() noexcept
+    {
+        static std::atomic<std::uint64_t> id{0};
+        return id.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    static std::unordered_set<std::uint64_t>& registry()
+    {
+        static std::unordered_set<std::uint64_t> ids;
+        return ids;
+    }
+
+    static std::mutex& registry_lock()
+    {
+        static std::mutex lock;
+        return lock;
+    }
+
+    const std::uint64_t _id;
+};
+
+/*
+ * The calling thread's slot in object @param id; @param make creates it
+ * on the thread's first use. The last object used is one compare away.
+ *
+ * The thread's map drops the entries of destroyed objects once it has
+ * doubled since it was last pruned: it stays within twice the live
+ * objects the thread uses, whatever the number of objects it outlives.
+ */
+template <typename SLOT, typename MAKE>
+SLOT& thread_slot(std::uint64_t id, MAKE&& make)
+{
+    thread_local std::uint64_t lastId(0);
+    thread_local SLOT*         lastSlot(nullptr);
+    if (lastId == id) [[likely]] {
+        return *lastSlot;
+    }
+
+    struct slots_t
+    {
+        std::unordered_map<std::uint64_t, SLOT*> _slots;
+        std::size_t                              _pruneAt = 16;
+    };
+    thread_local slots_t t;
+
+    auto it(t._slots.find(id));
+    if (it == t._slots.end()) {
+        if (t._slots.size() >= t._pruneAt) {
+            object_id::prune(t._slots);
+            t._pruneAt = std::max<std::size_t>(16, 2 * t._slots.size());
+        }
+        it = t._slots.emplace(id, make()).first;
+    }
+    lastId   = id;
+    lastSlot = it->second;
+    return *lastSlot;
+}
+
+} // namespace lpt::detail
+
+
+#endif //#define INCLUDED_thread_slots_hpp_5c2e8a13_d7f4_4b69_9e01_a3b6f48c27d5
@@ -0,0 +1,338 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  \brief Scoped tracer: per thread flight recorder, Chrome trace JSON output; Linux, C++20
+ *
+ */
+
+#ifndef INCLUDED_trace_hpp_b41e6c08_7f3a_4d95_a2c7_19d5e8f06b3c
+#define INCLUDED_trace_hpp_b41e6c08_7f3a_4d95_a2c7_19d5e8f06b3c
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace lpt {
+
+/*
+ * Timelines: scopes record begin and end events in a ring buffer of the
+ * calling thread; write_json() turns the buffers into Chrome trace event
+ * JSON, for chrome://tracing or https://ui.perfetto.dev.
+ *
+ * \code
+ *     lpt::trace::write_at_exit("app.trace.json");
+ *     ...
+ *     void parse()
+ *     {
+ *         lpt::trace::scope s("parse");
+ *         ...
+ *     }
+ * \endcode
+ */
+namespace trace {
+
+/// Events kept per ring: the oldest are overwritten
+inline constexpr std::size_t ring_size = 16 * 1024;
+
+static_assert((ring_size & (ring_size - 1)) == 0);
+
+enum class phase : char
+{
+    begin = 'B',
+    end   = 'E',
+};
+
+/// A copy of a recorded event
+struct event
+{
+    std::uint64_t _ns;      // steady_clock
+    const char*   _name;    // static
+    std::uint32_t _tid;
+    phase         _phase;
+};
+
+/*
+ * One writer, the owning thread. Events are published by the release
+ * store of _head. A reader copies them then re-reads _head: events the
+ * writer lapped meanwhile are dropped, seqlock style. Fields are relaxed
+ * atomics so that the copy is not a data race.
+ */
+class ring
+{
+public:
+
+    ring() : _tid(static_cast<std::uint32_t>(::gettid())) {}
+
+    ~ring()                      = default;
+
+    ring(const ring&)            = delete;
+    ring& operator=(const ring&) = delete;
+    ring(ring&&)                 = delete;
+    ring& operator=(ring&&)      = delete;
+
+    void record(const char* name, phase ph, std::uint64_t ns) noexcept
+    {
+        const std::uint64_t head(_head.load(std::memory_order_relaxed));
+        slot& s(_slots[head & (ring_size - 1)]);
+        s._ns.store(ns, std::memory_order_relaxed);
+        s._name.store(name, std::memory_order_relaxed);
+        s._tid.store(_tid, std::memory_order_relaxed);
+        s._phase.store(ph, std::memory_order_relaxed);
+        _head.store(head + 1, std::memory_order_release);
+    }
+
+    /// The events still in the ring, oldest first
+    std::vector<event> read() const
+    {
+        const std::uint64_t head(_head.load(std::memory_order_acquire));
+        const std::uint64_t first(head > ring_size ? head - ring_size : 0);
+
+        std::vector<event> events;
+        events.reserve(head - first);
+        for (std::uint64_t i = first; i < head; ++i) {
+            const slot& s(_slots[i & (ring_size - 1)]);
+            events.push_back({s._ns.load(std::memory_order_relaxed),
+                              s._name.load(std::memory_order_relaxed),
+                              s._tid.load(std::memory_order_relaxed),
+                              s._phase.load(std::memory_order_relaxed)});
+        }
+
+        // The writer may be in slot after, not yet published: that of index after - ring_size
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const std::uint64_t after(_head.load(std::memory_order_relaxed));
+        const std::uint64_t lapped(after + 1 > ring_size ? after + 1 - ring_size : 0);
+        if (lapped > first) {
+            events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(std::min(lapped, head) - first));
+        }
+        return events;
+    }
+
+    /// For the calling thread, once the previous owner exited: its events stay until overwritten
+    void reuse() noexcept
+    {
+        _tid = static_cast<std::uint32_t>(::gettid());
+    }
+
+private:
+
+    struct slot
+    {
+        std::atomic<std::uint64_t> _ns{0};
+        std::atomic<const char*>   _name{nullptr};
+        std::atomic<std::uint32_t> _tid{0};
+        std::atomic<phase>         _phase{phase::begin};
+    };
+
+    std::array<slot, ring_size>  _slots;
+    std::atomic<std::uint64_t>   _head{0};
+    std::uint32_t                _tid;    // of the owner; only the owner reads it
+};
+
+class registry
+{
+public:
+
+    static registry& instance()
+    {
+        static registry r;
+        return r;
+    }
+
+    /*
+     * The calling thread's ring, from its first event. When the thread
+     * exits the ring is retired: a new thread appends to it, so the
+     * exited thread's events are lost only as the ring wraps. Rings are
+     * as many as the most threads alive at once.
+     */
+    ring& local()
+    {
+        thread_local const owner o(acquire());
+        return *o._ring;
+    }
+
+    /*
+     * Chrome trace event format. An end whose begin was overwritten is
+     * dropped; a begin without end shows as still open. A ring holds the
+     * events of its owners one after the other.
+     */
+    void write_json(std::ostream& os)
+    {
+        const auto pid(::getpid());
+        const char* sep("");
+
+        os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        std::lock_guard<std::mutex> lock(_lock);
+        for (const auto& r : _rings) {
+            std::size_t   depth(0);
+            std::uint32_t tid(0);
+            for (const event& e : r->read()) {
+                if (e._tid != tid) {
+                    tid   = e._tid;
+                    depth = 0;
+                }
+                if (e._phase == phase::end) {
+                    if (depth == 0) {
+                        continue;
+                    }
+                    --depth;
+                } else {
+                    ++depth;
+                }
+
+                char ts[32];
+                std::snprintf(ts, sizeof(ts), "%llu.%03llu",
+                              static_cast<unsigned long long>(e._ns / 1000),
+                              static_cast<unsigned long long>(e._ns % 1000));
+                os << sep << "\n{\"name\":\"";
+                escape(os, e._name);
+                os << "\",\"ph\":\"" << static_cast<char>(e._phase)
+                   << "\",\"ts\":" << ts
+                   << ",\"pid\":" << pid
+                   << ",\"tid\":" << e._tid << '}';
+                sep = ",";
+            }
+        }
+        os << "\n]}\n" << std::flush;
+    }
+
+private:
+
+    registry() = default;
+
+    struct owner
+    {
+        ~owner()
+        {
+            registry::instance().retire(_ring);
+        }
+
+        ring* _ring;
+    };
+
+    ring* acquire()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if ( ! _retired.empty()) {
+            ring* r(_retired.back());
+            _retired.pop_back();
+            r->reuse();
+            return r;
+        }
+        _rings.push_back(std::make_unique<ring>());
+        return _rings.back().get();
+    }
+
+    void retire(ring* r)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _retired.push_back(r);
+    }
+
+    static void escape(std::ostream& os, const char* str)
+    {
+        for (; *str; ++str) {
+            const unsigned char c(static_cast<unsigned char>(*str));
+            if (c == '"' || c == '\\') {
+                os << '\\' << *str;
+            } else if (c < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                os << buf;
+            } else {
+                os << *str;
+            }
+        }
+    }
+
+    std::mutex                          _lock;      // ring registration and output
+    std::vector<std::unique_ptr<ring>>  _rings;
+    std::vector<ring*>                  _retired;   // of exited threads
+};
+
+inline std::uint64_t now() noexcept
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// Registers the calling thread's ring, to keep the allocation off its first scope
+inline void register_thread()
+{
+    registry::instance().local();
+}
+
+inline void write_json(std::ostream& os)
+{
+    registry::instance().write_json(os);
+}
+
+/// Write the trace to @param path when the process exits normally
+inline void write_at_exit(std::string path)
+{
+    static std::string file;
+    file = std::move(path);
+    registry::instance();   // constructed before the handler runs, destroyed after
+    std::atexit([] {
+        std::ofstream os(file);
+        write_json(os);
+    });
+}
+
+/*
+ * Records a begin event now and the end event in the destructor: a
+ * clock read and five relaxed stores each; no lock, no allocation (but
+ * the thread's first, @see register_thread()).
+ *
+ * @param name is kept by address: a string literal.
+ */
+class scope
+{
+public:
+
+    template <std::size_t N>
+    explicit scope(const char (&name)[N]) noexcept
+        : _ring(registry::instance().local())
+        , _name(name)
+    {
+        _ring.record(_name, phase::begin, now());
+    }
+
+    ~scope()
+    {
+        _ring.record(_name, phase::end, now());
+    }
+
+    scope(const scope&)            = delete;
+    scope& operator=(const scope&) = delete;
+    scope(scope&&)                 = delete;
+    scope& operator=(scope&&)      = delete;
+
+private:
+
+    ring&       _ring;
+    const char* _name;
+
+}; // scope
+
+} // namespace trace
+
+} //namespace lpt
+
+
+#endif //#define INCLUDED_trace_hpp_b41e6c08_7f3a_4d95_a2c7_19d5e8f06b3c
@@ -0,0 +1,87 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under LGPL 3.0 or later.
+ *
+ *  \brief LEB128 varints and zigzag; C++20
+ *
+ */
+
+#ifndef INCLUDED_varint_hpp_a93f6d12_4c8e_47b1_bd05_6e2a1f97c8d4
+#define INCLUDED_varint_hpp_a93f6d12_4c8e_47b1_bd05_6e2a1f97c8d4
+
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace lpt::varint {
+
+/// Small magnitudes, of either sign, to small unsigned
+constexpr std::uint64_t zigzag(std::int64_t v) noexcept
+{
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+constexpr std::int64_t unzigzag(std::uint64_t v) noexcept
+{
+    return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+inline void put(std::string& out, std::uint64_t v)
+{
+    while (v >= 0x80) {
+        out.push_back(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<char>(v));
+}
+
+inline void put(std::ostream& os, std::uint64_t v)
+{
+    while (v >= 0x80) {
+        os.put(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    os.put(static_cast<char>(v));
+}
+
+/// Consumes the varint from @param in; throws std::runtime_error if malformed
+inline std::uint64_t get(std::string_view& in)
+{
+    std::uint64_t v(0);
+    for (unsigned shift = 0; shift < 64 && ! in.empty(); shift += 7) {
+        const auto c(static_cast<unsigned char>(in.front()));
+        in.remove_prefix(1);
+        v |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+        if ( ! (c & 0x80)) {
+            return v;
+        }
+    }
+    throw std::runtime_error("varint: truncated or too long");
+}
+
+inline std::uint64_t get(std::istream& is)
+{
+    std::uint64_t v(0);
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        const int c(is.get());
+        if (c == std::char_traits<char>::eof()) {
+            throw std::runtime_error("varint: truncated");
+        }
+        v |= static_cast<std::uint64_t>(c & 0x7f) << shift;
+        if ( ! (c & 0x80)) {
+            return v;
+        }
+    }
+    throw std::runtime_error("varint: too long");
+}
+
+} // namespace lpt::varint
+
+
+#endif //#define INCLUDED_varint_hpp_a93f6d12_4c8e_47b1_bd05_6e2a1f97c8d4
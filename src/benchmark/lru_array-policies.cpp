@@ -0,0 +1,116 @@
+/*
+ * lru_array eviction policies and admission filters: trace replay, hit
+ * ratio and time/op.
+ *
+ * Usage: ./lru_array-policies [benchmark options] [trace-file]
+ *   trace-file: one integer key per line. Without it: a Zipf(0.99)
+ *   workload over 1M keys, interrupted by sequential scans of one time
+ *   keys.
+ */
+
+#include <lpt/lru_array.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+constexpr const size_t cacheSize   = 8192;
+constexpr const size_t numKeys     = 1024*1024;
+constexpr const size_t traceLength = 1024*1024*4;
+constexpr const size_t scanEvery   = 1024*64;   // trace positions
+constexpr const size_t scanLength  = 1024*16;
+
+using trace_t = std::vector<uint64_t>;
+
+static trace_t synthetic_trace()
+{
+    std::vector<double> cdf(numKeys);
+    double sum(0);
+    for (size_t i = 0; i < numKeys; ++i) {
+        sum += 1.0 / std::pow(i + 1, 0.99);
+        cdf[i] = sum;
+    }
+
+    std::mt19937_64                        rng(42);
+    std::uniform_real_distribution<double> uniform(0, sum);
+    uint64_t                               scanKey(numKeys);
+
+    trace_t trace;
+    trace.reserve(traceLength);
+    while (trace.size() < traceLength) {
+        if (trace.size() % scanEvery == 0) {
+            for (size_t i = 0; i < scanLength; ++i) {
+                trace.push_back(scanKey++);
+            }
+        }
+        const auto it(std::lower_bound(cdf.begin(), cdf.end(), uniform(rng)));
+        trace.push_back(it - cdf.begin());
+    }
+    return trace;
+}
+
+static trace_t g_trace;
+
+//-----------------------------------------------------------------------------
+template <template <std::size_t> class POLICY,
+          template <std::size_t> class ADMISSION = lpt::admission::always>
+static void BM_Replay(benchmark::State& state) {
+  using cache_t = lpt::lru_array<uint64_t, uint64_t, cacheSize, POLICY, ADMISSION>;
+  auto pCache(std::make_unique<cache_t>());
+
+  size_t hits{0};
+  size_t lookups{0};
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    pCache->clear();
+    state.ResumeTiming();
+
+    for (const auto key : g_trace) {
+      if (const uint64_t* p = pCache->find(key); p) {
+        benchmark::DoNotOptimize( hits += (*p == key) );
+      } else {
+        pCache->push(key, key);
+      }
+    }
+    lookups += g_trace.size();
+  }
+  state.counters["HitRatio"] = benchmark::Counter(lookups ? double(hits)/lookups : 0);
+  state.counters["Time/op"]  = benchmark::Counter(g_trace.size(),
+                                                  benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert);
+}
+BENCHMARK_TEMPLATE(BM_Replay, lpt::eviction::lru)   ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Replay, lpt::eviction::clock) ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Replay, lpt::eviction::sieve) ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Replay, lpt::eviction::two_q) ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Replay, lpt::eviction::s3fifo)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Replay, lpt::eviction::lru,   lpt::admission::tinylfu)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Replay, lpt::eviction::sieve, lpt::admission::tinylfu)->Unit(benchmark::kMillisecond);
+
+
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+
+    if (argc > 1) {
+        std::ifstream in(argv[1]);
+        for (uint64_t key; in >> key; ) {
+            g_trace.push_back(key);
+        }
+        std::cout << argv[1] << ": " << g_trace.size() << " keys\n";
+    } else {
+        g_trace = synthetic_trace();
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * lru_array behind a global mutex vs concurrent_lru_array shards.
+ * 90% lookups, 10% inserts over a key range twice the capacity.
+ */
+
+#include <lpt/concurrent_lru_array.hpp>
+#include <lpt/lru_array.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <random>
+
+//-----------------------------------------------------------------------------
+constexpr const size_t numTotalLoops = 1024*1024*32;
+constexpr const size_t maxNumThreads = 128;
+
+constexpr const size_t cacheSize = 4096;
+constexpr const size_t keyRange  = 2*cacheSize;
+
+struct Value
+{
+    uint64_t _data[4];
+};
+
+static void BM_GlobalMutex(benchmark::State& state) {
+  static lpt::lru_array<uint64_t, Value, cacheSize> cache;
+  static std::mutex                                 mutexCache;
+
+  const auto nLoops{numTotalLoops/state.threads()};
+  std::minstd_rand rng(state.thread_index() + 1);
+  uint64_t hits{0};
+
+  for (auto _ : state) {
+    for (size_t n = 0; n < nLoops; ++n) {
+      const uint64_t key(rng() % keyRange);
+      std::lock_guard<std::mutex> lock(mutexCache);
+      if (n % 10 == 0) {
+        cache.push(key, Value{{key}});
+      } else {
+        benchmark::DoNotOptimize( hits += (cache.find(key) != nullptr) );
+      }
+    }
+  }
+  state.counters["Rate"] = benchmark::Counter(numTotalLoops, benchmark::Counter::kAvgThreadsRate);
+  state.SetComplexityN(state.threads());
+}
+BENCHMARK(BM_GlobalMutex)
+    ->ThreadRange(1, maxNumThreads)
+    ->UseRealTime()
+    ->Complexity(benchmark::oAuto)
+    ;
+
+template <size_t SHARDS>
+static void BM_Sharded(benchmark::State& state) {
+  static lpt::concurrent_lru_array<uint64_t, Value, cacheSize, SHARDS> cache;
+
+  const auto nLoops{numTotalLoops/state.threads()};
+  std::minstd_rand rng(state.thread_index() + 1);
+  uint64_t hits{0};
+
+  for (auto _ : state) {
+    for (size_t n = 0; n < nLoops; ++n) {
+      const uint64_t key(rng() % keyRange);
+      if (n % 10 == 0) {
+        cache.push(key, Value{{key}});
+      } else {
+        benchmark::DoNotOptimize( hits += cache.visit(key, [](const Value&){}) );
+      }
+    }
+  }
+  state.counters["Rate"] = benchmark::Counter(numTotalLoops, benchmark::Counter::kAvgThreadsRate);
+  state.SetComplexityN(state.threads());
+}
+BENCHMARK_TEMPLATE(BM_Sharded, 16)
+    ->ThreadRange(1, maxNumThreads)
+    ->UseRealTime()
+    ->Complexity(benchmark::oAuto)
+    ;
+BENCHMARK_TEMPLATE(BM_Sharded, 64)
+    ->ThreadRange(1, maxNumThreads)
+    ->UseRealTime()
+    ->Complexity(benchmark::oAuto)
+    ;
+
+
+BENCHMARK_MAIN();
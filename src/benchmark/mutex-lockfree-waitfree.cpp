@@ -1,3 +1,6 @@
+#include <lpt/adaptive_mutex.hpp>
+#include <lpt/spinlock.hpp>
+
 #include <benchmark/benchmark.h>
 
 #include <atomic>
@@ -80,6 +83,48 @@ BENCHMARK(BM_PtSpin)
     ->Complexity(benchmark::oAuto)
     ;
 
+static void BM_Spinlock(benchmark::State& state) {
+  static unsigned long  counterMtx{0};
+  static lpt::spinlock  mutexCounterMtx;
+
+  const auto nLoops{numTotalLoops/state.threads()};
+
+  for (auto _ : state) {
+    for (size_t n = 0; n < nLoops; ++n) {
+      std::lock_guard<lpt::spinlock> lock(mutexCounterMtx);
+      benchmark::DoNotOptimize( ++counterMtx );
+    }
+  }
+  state.counters["Rate"] = benchmark::Counter(numTotalLoops, benchmark::Counter::kAvgThreadsRate);
+  state.SetComplexityN(state.threads());
+}
+BENCHMARK(BM_Spinlock)
+    ->ThreadRange(1, maxNumThreads)
+    ->UseRealTime()
+    ->Complexity(benchmark::oAuto)
+    ;
+
+static void BM_Adaptive(benchmark::State& state) {
+  static unsigned long        counterMtx{0};
+  static lpt::adaptive_mutex  mutexCounterMtx;
+
+  const auto nLoops{numTotalLoops/state.threads()};
+
+  for (auto _ : state) {
+    for (size_t n = 0; n < nLoops; ++n) {
+      std::lock_guard<lpt::adaptive_mutex> lock(mutexCounterMtx);
+      benchmark::DoNotOptimize( ++counterMtx );
+    }
+  }
+  state.counters["Rate"] = benchmark::Counter(numTotalLoops, benchmark::Counter::kAvgThreadsRate);
+  state.SetComplexityN(state.threads());
+}
+BENCHMARK(BM_Adaptive)
+    ->ThreadRange(1, maxNumThreads)
+    ->UseRealTime()
+    ->Complexity(benchmark::oAuto)
+    ;
+
 static void BM_LockFree(benchmark::State& state) {
   static std::atomic<unsigned long>  counter{0};
   //static std::atomic<unsigned long>* pCounter = &counter;
@@ -0,0 +1,107 @@
+/*
+ * lpt::ordered_set (std::set) vs lpt::indexed_heap (4-ary, contiguous)
+ * as priority queues of 1K, 100K and 10M items:
+ *   - PushPop: pop the top, push a random item;
+ *   - Update:  re-prioritize a random item (erase+push for the set).
+ */
+
+#include <lpt/indexed_heap.hpp>
+#include <lpt/lru_array.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+constexpr const size_t numOps = 1024*64;
+
+using set_t  = lpt::ordered_set<uint64_t>;
+using heap_t = lpt::indexed_heap<uint64_t>;
+
+// Random 64 bit items: collisions, which the set would merge, are negligible
+static void BM_PushPop_OrderedSet(benchmark::State& state) {
+  const size_t     count(state.range(0));
+  std::mt19937_64  rng(42);
+  set_t            set;
+  for (size_t i = 0; i < count; ++i) {
+    set.push(rng());
+  }
+
+  for (auto _ : state) {
+    for (size_t n = 0; n < numOps; ++n) {
+      benchmark::DoNotOptimize(set.top());
+      set.pop();
+      set.push(rng());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * numOps);
+}
+
+static void BM_PushPop_IndexedHeap(benchmark::State& state) {
+  const size_t     count(state.range(0));
+  std::mt19937_64  rng(42);
+  heap_t           heap;
+  heap.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    heap.push(rng());
+  }
+
+  for (auto _ : state) {
+    for (size_t n = 0; n < numOps; ++n) {
+      benchmark::DoNotOptimize(heap.top());
+      heap.pop();
+      heap.push(rng());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * numOps);
+}
+
+static void BM_Update_OrderedSet(benchmark::State& state) {
+  const size_t          count(state.range(0));
+  std::mt19937_64       rng(42);
+  set_t                 set;
+  std::vector<uint64_t> items(count);
+  for (auto& item : items) {
+    item = rng();
+    set.push(item);
+  }
+
+  for (auto _ : state) {
+    for (size_t n = 0; n < numOps; ++n) {
+      auto& item(items[rng() % count]);
+      set.erase(item);
+      item = rng();
+      set.push(item);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * numOps);
+}
+
+static void BM_Update_IndexedHeap(benchmark::State& state) {
+  const size_t                   count(state.range(0));
+  std::mt19937_64                rng(42);
+  heap_t                         heap;
+  std::vector<heap_t::handle_t>  handles(count);
+  heap.reserve(count);
+  for (auto& h : handles) {
+    h = heap.push(rng());
+  }
+
+  for (auto _ : state) {
+    for (size_t n = 0; n < numOps; ++n) {
+      heap.update(handles[rng() % count], rng());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * numOps);
+}
+
+#define HEAP_SIZES ->Arg(1000)->Arg(100*1000)->Arg(10*1000*1000)->Unit(benchmark::kMillisecond)
+
+BENCHMARK(BM_PushPop_OrderedSet)  HEAP_SIZES;
+BENCHMARK(BM_PushPop_IndexedHeap) HEAP_SIZES;
+BENCHMARK(BM_Update_OrderedSet)   HEAP_SIZES;
+BENCHMARK(BM_Update_IndexedHeap)  HEAP_SIZES;
+
+BENCHMARK_MAIN();
@@ -3,6 +3,8 @@
 
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <iostream>
 #include <mutex>
@@ -32,57 +34,85 @@ private:
     pthread_spinlock_t _lock;
 };
 
+//-----------------------------------------------------------------------------
+// mcs_lock with the queue node on the stack
+class McsGuardWrap
+{
+public:
+
+    using guard_t = lpt::mcs_lock::guard;
+
+    lpt::mcs_lock _lock;
+};
+
+template <typename LOCK_T>
+struct Locker
+{
+    Locker(LOCK_T& l) : _guard(l) {}
+    std::lock_guard<LOCK_T> _guard;
+};
+
+template <>
+struct Locker<McsGuardWrap>
+{
+    Locker(McsGuardWrap& l) : _guard(l._lock) {}
+    McsGuardWrap::guard_t _guard;
+};
+
 //-----------------------------------------------------------------------------
 constexpr const size_t numTotalLoops = 1024*1024*32;
 constexpr const size_t maxNumThreads = 128;
 
-static void BM_Pikus(benchmark::State& state) {
-  static unsigned long  counterMtx{0};
-  //static unsigned long* pCounterMtx = &counterMtx;
-  static lpt::spinlock  spinlockCounterMtx;
+/*
+ * The threads share numTotalLoops acquisitions: a fair lock gives each
+ * about the same number. Fairness = min/max per thread acquisitions.
+ */
+template <typename LOCK_T>
+static void BM_Lock(benchmark::State& state) {
+  static unsigned long                        counterMtx{0};
+  static LOCK_T                               lockCounterMtx;
+  static std::array<size_t, maxNumThreads>    acquisitions;
+
+  if (state.thread_index() == 0) {
+    counterMtx = 0;
+    acquisitions.fill(0);
+  }
 
-  const auto nLoops{numTotalLoops/state.threads()};
-  
+  size_t iterations{0};
   for (auto _ : state) {
-    for (size_t n = 0; n < nLoops; ++n) {
-      std::lock_guard<lpt::spinlock> lock(spinlockCounterMtx);
+    const auto target{++iterations * numTotalLoops};
+    size_t     mine{0};
+    for (;;) {
+      Locker<LOCK_T> lock(lockCounterMtx);
+      if (counterMtx >= target) {
+        break;
+      }
       benchmark::DoNotOptimize( ++counterMtx );
+      ++mine;
     }
+    acquisitions[state.thread_index()] += mine;
   }
-  state.counters["Rate"] = benchmark::Counter(numTotalLoops, benchmark::Counter::kAvgThreadsRate);
-  state.SetComplexityN(state.threads());
-}
-BENCHMARK(BM_Pikus)
-    ->ThreadRange(1, maxNumThreads)
-    ->UseRealTime()
-    ->Complexity(benchmark::oAuto)
-    //->ComputeStatistics("max", [](const std::vector<double>& v) -> double {
-    //      return *(std::max_element(std::begin(v), std::end(v)));
-    //  })
-    ;
-
-static void BM_PtSpin(benchmark::State& state) {
-  static unsigned long        counterMtx{0};
-  //static unsigned long*       pCounterMtx = &counterMtx;
-  static PtreadsSpinLockWrap  mutexCounterMtx;
-
-  const auto nLoops{numTotalLoops/state.threads()};
-  
-  for (auto _ : state) {
-    for (size_t n = 0; n < nLoops; ++n) {
-      std::lock_guard<PtreadsSpinLockWrap> lock(mutexCounterMtx);
-      benchmark::DoNotOptimize( ++counterMtx );
-    }
+
+  // Threads are past the end barrier
+  if (state.thread_index() == 0) {
+    const auto [minAcq, maxAcq] = std::minmax_element(acquisitions.begin(), acquisitions.begin() + state.threads());
+    state.counters["MinAcq"]   = benchmark::Counter(*minAcq);
+    state.counters["MaxAcq"]   = benchmark::Counter(*maxAcq);
+    state.counters["Fairness"] = benchmark::Counter(*maxAcq ? double(*minAcq) / *maxAcq : 1);
   }
   state.counters["Rate"] = benchmark::Counter(numTotalLoops, benchmark::Counter::kAvgThreadsRate);
   state.SetComplexityN(state.threads());
 }
-BENCHMARK(BM_PtSpin)
-    ->ThreadRange(1, maxNumThreads)
-    ->UseRealTime()
-    ->Complexity(benchmark::oAuto)
-    ;
 
+#define LOCK_THREADS ->ThreadRange(1, maxNumThreads)->UseRealTime()->Complexity(benchmark::oAuto)
+
+BENCHMARK_TEMPLATE(BM_Lock, lpt::spinlock)        LOCK_THREADS;
+BENCHMARK_TEMPLATE(BM_Lock, PtreadsSpinLockWrap)  LOCK_THREADS;
+BENCHMARK_TEMPLATE(BM_Lock, lpt::ticket_spinlock) LOCK_THREADS;
+BENCHMARK_TEMPLATE(BM_Lock, lpt::mcs_lock)        LOCK_THREADS;
+BENCHMARK_TEMPLATE(BM_Lock, McsGuardWrap)         LOCK_THREADS;
+BENCHMARK_TEMPLATE(BM_Lock, lpt::clh_lock)        LOCK_THREADS;
+BENCHMARK_TEMPLATE(BM_Lock, std::mutex)           LOCK_THREADS;
 
-BENCHMARK_MAIN();
 
+BENCHMARK_MAIN();
@@ -2,6 +2,8 @@
  * std::share_mutex/rw-lock vs mutex
  */
 
+#include <lpt/rw_lock.hpp>
+
 #include <benchmark/benchmark.h>
 
 #include <atomic>
@@ -67,6 +69,64 @@ BENCHMARK(BM_RWLock)
     //  })
     ;
 
+static void BM_LptRWLock(benchmark::State& state) {
+  static unsigned long  counterMtx{0};
+  static lpt::rw_lock   mutexCounterMtx;
+
+  const auto nLoops{numTotalLoops/state.threads()};
+
+  unsigned long val;
+
+  for (auto _ : state) {
+    for (size_t n = 0; n < nLoops; ++n) {
+      std::shared_lock lock(mutexCounterMtx);
+      benchmark::DoNotOptimize( val = counterMtx );
+    }
+  }
+  state.counters["Rate"] = benchmark::Counter(numTotalLoops, benchmark::Counter::kAvgThreadsRate);
+  state.SetComplexityN(state.threads());
+}
+BENCHMARK(BM_LptRWLock)
+    ->ThreadRange(1, maxNumThreads)
+    ->UseRealTime()
+    ->Complexity(benchmark::oAuto)
+    ;
+
+// 1 write every 1024 reads
+template <typename LOCK_T>
+static void BM_ReadMostly(benchmark::State& state) {
+  static unsigned long  counterMtx{0};
+  static LOCK_T         mutexCounterMtx;
+
+  const auto nLoops{numTotalLoops/state.threads()};
+
+  unsigned long val;
+
+  for (auto _ : state) {
+    for (size_t n = 0; n < nLoops; ++n) {
+      if (n % 1024 == 0) {
+        std::unique_lock lock(mutexCounterMtx);
+        benchmark::DoNotOptimize( ++counterMtx );
+      } else {
+        std::shared_lock lock(mutexCounterMtx);
+        benchmark::DoNotOptimize( val = counterMtx );
+      }
+    }
+  }
+  state.counters["Rate"] = benchmark::Counter(numTotalLoops, benchmark::Counter::kAvgThreadsRate);
+  state.SetComplexityN(state.threads());
+}
+BENCHMARK_TEMPLATE(BM_ReadMostly, std::shared_mutex)
+    ->ThreadRange(1, maxNumThreads)
+    ->UseRealTime()
+    ->Complexity(benchmark::oAuto)
+    ;
+BENCHMARK_TEMPLATE(BM_ReadMostly, lpt::rw_lock)
+    ->ThreadRange(1, maxNumThreads)
+    ->UseRealTime()
+    ->Complexity(benchmark::oAuto)
+    ;
+
 
 BENCHMARK_MAIN();
 
@@ -0,0 +1,55 @@
+/*
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  Lock contention report: kill -USR2 <pid> while it runs, or wait for exit.
+ *
+ */
+
+#include <lpt/profiled_mutex.hpp>
+#include <lpt/spinlock.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+lpt::profiled_mutex<std::mutex>    g_slow;
+lpt::profiled_mutex<lpt::spinlock> g_fast;
+unsigned long                      g_slowCounter{0};
+unsigned long                      g_fastCounter{0};
+
+void hot_path()
+{
+    std::lock_guard<lpt::profiled_mutex<std::mutex>> lock(g_slow);
+    ++g_slowCounter;
+    std::this_thread::sleep_for(std::chrono::microseconds(20));
+}
+
+void cold_path()
+{
+    std::lock_guard<lpt::profiled_mutex<lpt::spinlock>> lock(g_fast);
+    ++g_fastCounter;
+}
+
+int main()
+{
+    lpt::lock_profiler::sampling(16);
+    lpt::lock_profiler::report_at_exit();
+    lpt::lock_profiler::report_on_signal(SIGUSR2);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([] {
+            for (int n = 0; n < 2000; ++n) {
+                hot_path();
+                cold_path();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    return 0;
+}
@@ -7,12 +7,49 @@
  */
 
 #include <lpt/chrono.hpp>
+#include <lpt/hdr_histogram.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <string_view>
 #include <thread>
+#include <type_traits>
+#include <vector>
 
 
 //-----------------------------------------------------------------------------
+// Self overhead: the cost of a timepoint+elapsed() pair, and the smallest
+// non zero interval it reports
+template <typename TIMEPOINT>
+void overhead(const char* name)
+{
+    constexpr int loops = 1'000'000;
+
+    long long sink(0);
+    long long resolution(std::numeric_limits<long long>::max());
+    lpt::stats::hdr_histogram<> intervals;
+
+    const lpt::chrono::std_timepoint total;
+    for (int i = 0; i < loops; ++i) {
+        const TIMEPOINT tp;
+        const auto      ns(tp.elapsed().count());
+        sink += ns;
+        intervals.record(static_cast<std::uint64_t>(std::max<long long>(ns, 0)));
+        if (ns > 0) {
+            resolution = std::min<long long>(resolution, ns);
+        }
+    }
+    const auto elapsed(total.elapsed());
+
+    std::cout << name << ": "
+              << static_cast<double>(elapsed.count()) / loops << " ns/pair, "
+              << "min interval " << resolution << " ns, "
+              << "mean interval " << static_cast<double>(sink) / loops << " ns, "
+              << "p50/p99/p99.99 " << intervals.percentile(50) << '/' << intervals.percentile(99)
+              << '/' << intervals.percentile(99.99) << " ns\n";
+}
+
 int main()
 {
     {
@@ -24,6 +61,56 @@ int main()
         std::this_thread::sleep_for(std::chrono::seconds(1));
     }
 
+    // Tags that do not allocate: held by value, or viewed
+    {
+        const auto report([](auto&& tag, auto&& dur) {
+            std::cout << tag << ": " << dur.count() << std::endl;
+        });
+        using report_t = std::decay_t<decltype(report)>;
+
+        lpt::chrono::measurement tm1(lpt::make_constexpr_string("constexpr_string tag"), report);
+        static_assert(std::is_same_v<decltype(tm1), lpt::chrono::measurement<report_t, lpt::chrono::timepoint, lpt::constexpr_string<20>>>);
+
+        static constexpr std::string_view tag("string_view tag");
+        lpt::chrono::measurement          tm2(tag, report);
+        static_assert(std::is_same_v<decltype(tm2), lpt::chrono::measurement<report_t, lpt::chrono::timepoint, std::string_view>>);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    overhead<lpt::chrono::std_timepoint>("std_timepoint  ");
+    overhead<lpt::chrono::posix_timepoint>("posix_timepoint");
+    std::cout << lpt::chrono::calibration<>::instance() << '\n';
+#if defined(__x86_64__) || defined(__i386__)
+    std::cout << "TSC: " << 1 / lpt::chrono::tsc_timepoint::ns_per_tick() << " ticks/ns, "
+              << (lpt::chrono::tsc_timepoint::invariant() ? "" : "NOT ") << "invariant\n";
+    overhead<lpt::chrono::tsc_timepoint>("tsc_timepoint  ");
+
+    {
+        lpt::chrono::accumulator acc("tsc accumulated");
+        for (int i = 0; i < 3; ++i) {
+            auto m(acc.measurement<lpt::chrono::tsc_timepoint>());
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        std::cout << acc << '\n';   // ~30'000'000 ns
+    }
+#endif
+
+    {
+        lpt::chrono::concurrent_accumulator acc("4 threads, concurrent_accumulator");
+        std::vector<std::thread>            threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&acc] {
+                for (int i = 0; i < 100'000; ++i) {
+                    auto m(acc.measurement());
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        std::cout << acc << '\n';   // 400000 calls
+    }
+
     return EXIT_SUCCESS; 
 }
-
@@ -0,0 +1,59 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under LGPL 3.0 or later.
+ *
+ *  Open loop load: service vs response time of a service that stalls.
+ *  The service times barely see the stalls; the response times of the
+ *  calls queued behind them do.
+ *
+ */
+
+#include <lpt/load_generator.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+//-----------------------------------------------------------------------------
+class service
+{
+public:
+
+    /// ~20 us a call; every 2000th call stalls 20 ms holding the lock
+    void get()
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (++_calls % 2000 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        const auto until(std::chrono::steady_clock::now() + std::chrono::microseconds(20));
+        while (std::chrono::steady_clock::now() < until) {}
+    }
+
+private:
+
+    std::mutex    _mtx;
+    unsigned long _calls = 0;
+};
+
+//-----------------------------------------------------------------------------
+int main()
+{
+    for (const auto arr : {lpt::chrono::arrivals::fixed, lpt::chrono::arrivals::poisson}) {
+        service                     svc;
+        lpt::chrono::load_generator load({._rate     = 10'000,
+                                          ._threads  = 2,
+                                          ._duration = std::chrono::seconds(2),
+                                          ._arrivals = arr});
+
+        std::cout << (arr == lpt::chrono::arrivals::fixed ? "Fixed" : "Poisson") << " arrivals:\n"
+                  << load.run([&svc] { svc.get(); })
+                  << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  Periodic stats reporter: interval percentiles of 4 threads.
+ *
+ */
+
+#include <lpt/chrono.hpp>
+#include <lpt/stats_reporter.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+    const std::string path(argc > 1 ? argv[1] : "reporter.csv");
+
+    lpt::stats::interval_dataset<>      latency("sleep_ns");
+    lpt::chrono::concurrent_accumulator busy("busy, \"spin\"");   // quoted in CSV, escaped in JSON
+    auto                                busyReport(lpt::stats::report(busy));
+
+    std::atomic<bool> stop(false);
+    {
+        const bool           json(path.ends_with(".json"));
+        lpt::stats::reporter rep(std::chrono::milliseconds(500), path,
+                                 json ? lpt::stats::reporter::format::json : lpt::stats::reporter::format::csv);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                while ( ! stop.load(std::memory_order_relaxed)) {
+                    {
+                        auto m(busy.measurement());
+                        volatile int sink(0);
+                        for (int i = 0; i < 1000 * (t + 1); ++i) {
+                            sink = sink + i;
+                        }
+                    }
+                    const lpt::chrono::timepoint tp;
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    latency(static_cast<double>(tp.elapsed().count()));
+                }
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+        stop = true;
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    std::cout << "Stats in " << path << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -7,6 +7,7 @@
  */
 
 #include <lpt/chrono_stats.hpp>
+#include <lpt/stats_compare.hpp>
 #include <lpt/compiler.hpp>
 #include <lpt/papi/papi.hpp>
 
@@ -153,6 +154,8 @@ int main()
 
    lpt::chrono::dataset statsAsVals(lpt::chrono::timepoint::name());
    lpt::chrono::dataset statsAsPcts("% Move/Copy");
+   lpt::chrono::sample_dataset copyDurations("Copy");
+   lpt::chrono::sample_dataset moveDurations("Move");
 
    for (auto loop : std::views::iota(1, numLoops+1))
    {
@@ -213,6 +216,8 @@ int main()
                 moveConstructionDuration = tm.elapsed();
                 statsAsPcts(moveConstructionDuration, copyConstructionDuration);
                 statsAsVals(moveConstructionDuration);
+                copyDurations(copyConstructionDuration);
+                moveDurations(moveConstructionDuration);
                 std::cout << "Move gain (negative: move is faster) % : " << lpt::chrono::timepoint::as_percent_of(moveConstructionDuration, copyConstructionDuration) << "\n"
                           << "copyConstructionDuration: " << copyConstructionDuration.count() << "\n"
                           << "moveConstructionDuration: " << moveConstructionDuration.count() << "\n"
@@ -255,6 +260,8 @@ int main()
     std::cout << "\n" << numLoops << " tests stats:\nPositive%: move is worse than copy\n"
               << statsAsVals
               << statsAsPcts
+              << "\nMove vs copy, 5% trimmed:\n"
+              << lpt::stats::compare(copyDurations, moveDurations, {._trim = 0.05})
               << std::endl;
 
    exit(EXIT_SUCCESS);    
@@ -0,0 +1,67 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  Scoped tracer: load the output in https://ui.perfetto.dev
+ *
+ */
+
+#include <lpt/chrono.hpp>
+#include <lpt/trace.hpp>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+void leaf()
+{
+    lpt::trace::scope s("leaf");
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+void branch()
+{
+    lpt::trace::scope s("branch \"quoted\"");
+    for (int i = 0; i < 3; ++i) {
+        leaf();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string path(argc > 1 ? argv[1] : "tracetest.json");
+    lpt::trace::write_at_exit(path);
+    lpt::trace::register_thread();   // own ring: the workers' rings are not overwritten
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([] {
+            lpt::trace::register_thread();
+            for (int i = 0; i < 20; ++i) {
+                branch();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // Overwrites the oldest events of this thread
+    constexpr int loops = 1'000'000;
+    {
+        lpt::chrono::measurement tm("scope cost",
+                                    [](auto&& tag, auto&& dur) {
+                                        std::cout << tag << ": " << static_cast<double>(dur.count()) / loops << " ns\n";
+                                    });
+        for (int i = 0; i < loops; ++i) {
+            lpt::trace::scope s("tight");
+        }
+    }
+
+    std::cout << "Trace in " << path << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -50,6 +50,7 @@ using counters = lpt::papi::counters<
 >;
 
 using accumulator_set = lpt::papi::accumulator_set<counters>;
+using hdr_accumulator_set = lpt::papi::hdr_accumulator_set<counters>;
 
 //-----------------------------------------------------------------------------
 /*
@@ -192,6 +193,7 @@ int main()
    counters::datapoint moveConstructRead;
 
    accumulator_set stats;
+   hdr_accumulator_set tails;
 
    copyConstructedData.reserve(vecSize);
    moveConstructedData.reserve(vecSize);
@@ -202,6 +204,11 @@ int main()
    lpt::papi::hardware().print(std::cout);
 
    counters ctrs;
+   const counters::datapoint floor(ctrs.calibrate());
+   std::cout << floor;
+   stats.subtract(floor);
+   tails.subtract(floor);
+
    auto cout_measurement = [](const counters::datapoint* measure) -> void {
                                   std::cout << *measure << std::endl;
                             };
@@ -281,14 +288,16 @@ int main()
         cout_measurement(&copyLessMoveConstructRead);
         as_percent("Diffusion (positive: move is worse)", moveConstructRead, copyConstructRead);
 
-        counters::datapoint::percents pcts(moveConstructRead.as_percent_of(copyConstructRead));
-        stats(pcts);
+        stats(moveConstructRead, copyConstructRead);
+        tails(moveConstructRead, copyConstructRead);
 
         std::cout << std::endl;
     } // for tests' loop
 
     std::cout << "\n" << numLoops << " tests stats:\nPositive%: move is worse than copy\n"
                << stats
+               << "\n"
+               << tails
                << std::endl;
 
 
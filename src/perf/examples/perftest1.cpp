@@ -0,0 +1,82 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under LGPL 3.0 or later.
+ *
+ *  perf_event_open counters: as papimove3, without PAPI or root.
+ *  In a VM without a PMU the hardware events fall back to software ones.
+ *
+ */
+
+#include <lpt/perf/perf.hpp>
+#include <lpt/papi/papi_stats.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+using counters = lpt::perf::counters<lpt::perf::event::instructions,
+                                     lpt::perf::event::cpu_cycles,
+                                     lpt::perf::event::branch_misses,
+                                     lpt::perf::event::l1d_read_misses,
+                                     lpt::perf::event::task_clock>;
+using accumulator_set     = lpt::papi::accumulator_set<counters>;
+using hdr_accumulator_set = lpt::papi::hdr_accumulator_set<counters>;
+
+//-----------------------------------------------------------------------------
+int main()
+{
+    std::cout << "Hardware PMU: " << (counters::hardware() ? "yes" : "no, software fallbacks") << "\n\n";
+
+    counters ctrs("Total");
+    const counters::datapoint floor(ctrs.calibrate());
+    std::cout << floor;
+
+    accumulator_set     stats;
+    hdr_accumulator_set tails;
+    stats.subtract(floor);
+    tails.subtract(floor);
+
+    std::vector<int> data(64 * 1024);
+    std::iota(data.begin(), data.end(), 0);
+
+    volatile long sink(0);
+    auto          noop = [](auto&&) {};
+    for (int loop = 0; loop < 100; ++loop) {
+        counters::datapoint sequential;
+        counters::datapoint strided;
+        {
+            counters::measurement m("Sequential sum", ctrs, noop);
+            long sum(0);
+            for (size_t i = 0; i < data.size(); ++i) {
+                sum += data[i];
+            }
+            sink = sum;
+            sequential = m.data();
+        }
+        {
+            counters::measurement m("Strided sum", ctrs, noop);
+            long sum(0);
+            for (size_t stride = 0; stride < 16; ++stride) {
+                for (size_t i = stride; i < data.size(); i += 16) {
+                    sum += data[i];
+                }
+            }
+            sink = sum;
+            strided = m.data();
+        }
+        if (loop == 0) {
+            std::cout << sequential << strided;
+        }
+        stats(strided, sequential);
+        tails(strided, sequential);
+    }
+
+    std::cout << "Strided vs sequential, %:\n" << stats << '\n' << tails << '\n'
+              << "Sum: " << sink << '\n';
+
+    return EXIT_SUCCESS;
+}
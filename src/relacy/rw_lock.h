@@ -0,0 +1,97 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  \brief Relacy model of lpt::basic_rw_lock (include/lpt/rw_lock.hpp)
+ *
+ */
+
+#ifndef INCLUDED_rw_lock_h_7d2a9c41_e58b_4f30_b6c1_0e4f8a3d92b7
+#define INCLUDED_rw_lock_h_7d2a9c41_e58b_4f30_b6c1_0e4f8a3d92b7
+
+#pragma once
+
+#include <relacy/relacy.hpp>
+
+namespace lpt {
+
+/*
+ * Same protocol and memory orders as lpt::basic_rw_lock. The writers'
+ * adaptive_mutex and the futex waits are modelled as spins; the reader
+ * slot is picked by relacy thread index.
+ */
+template <unsigned SLOTS>
+class rw_lock_model
+{
+public:
+
+    rw_lock_model()
+    {
+        for (unsigned i = 0; i < SLOTS; ++i) {
+            _slots[i]($).store(0, rl::mo_release);
+        }
+        _writer($).store(0, rl::mo_release);
+        _writers($).store(0, rl::mo_release);
+    }
+
+    void lock_shared()
+    {
+        auto& readers(slot());
+        for (;;) {
+            readers($).fetch_add(1, rl::mo_seq_cst);
+            if (_writer($).load(rl::mo_seq_cst) == 0) {
+                return;
+            }
+            readers($).fetch_sub(1, rl::mo_release);
+            while (_writer($).load(rl::mo_acquire) == 1) {
+                rl::yield(1, $);
+            }
+        }
+    }
+
+    void unlock_shared()
+    {
+        slot()($).fetch_sub(1, rl::mo_release);
+    }
+
+    void lock()
+    {
+        int expected(0);
+        while ( ! _writers($).compare_exchange_weak(expected, 1, rl::mo_acquire)) {
+            expected = 0;
+            rl::yield(1, $);
+        }
+
+        _writer($).store(1, rl::mo_seq_cst);
+        for (unsigned i = 0; i < SLOTS; ++i) {
+            while (_slots[i]($).load(rl::mo_seq_cst) != 0) {
+                rl::yield(1, $);
+            }
+        }
+    }
+
+    void unlock()
+    {
+        _writer($).store(0, rl::mo_release);
+        _writers($).store(0, rl::mo_release);
+    }
+
+private:
+
+    rl::atomic<int>& slot()
+    {
+        return _slots[rl::thread_index() % SLOTS];
+    }
+
+    rl::atomic<int> _slots[SLOTS];
+    rl::atomic<int> _writer;
+    rl::atomic<int> _writers;  // adaptive_mutex
+
+}; // rw_lock_model
+
+} //namespace lpt
+
+
+#endif //#define INCLUDED_rw_lock_h_7d2a9c41_e58b_4f30_b6c1_0e4f8a3d92b7
@@ -0,0 +1,72 @@
+//
+// lpt::rw_lock model test, 4 threads; the first WRITERS are writers, the
+// others readers. Reader thread i uses slot i % SLOTS:
+//   2 writers, 2 readers on 2 slots: readers 2 and 3 each have their own;
+//   2 writers, 2 readers on 1 slot:  readers 2 and 3 share it;
+//   1 writer,  3 readers on 2 slots: readers 1 and 3 share slot 1.
+// Expected bug free.
+//
+
+#include <relacy/relacy.hpp>
+
+#include "rw_lock.h"
+
+// template parameter '4' is number of threads
+template <unsigned SLOTS, unsigned WRITERS>
+struct rw_lock_test : rl::test_suite<rw_lock_test<SLOTS, WRITERS>, 4>
+{
+    lpt::rw_lock_model<SLOTS> rwl;
+    rl::var<int> x;
+
+    // executed in single thread before main thread function
+    void before()
+    {
+        x($) = 0;
+    }
+
+    // main thread function
+    void thread(unsigned thread_index)
+    {
+        if (thread_index < WRITERS)
+        {
+            rwl.lock();
+            const int y = x($);
+            x($) = y + 1;
+            rwl.unlock();
+        }
+        else // readers
+        {
+            rwl.lock_shared();
+            const int y1 = x($);
+            const int y2 = x($);
+            rwl.unlock_shared();
+            RL_ASSERT(y1 == y2);
+            RL_ASSERT(0 <= y1 && y1 <= static_cast<int>(WRITERS));
+        }
+    }
+
+    // executed in single thread after main thread function
+    void after()
+    {
+        RL_ASSERT(x($) == static_cast<int>(WRITERS));
+    }
+
+    // executed in single thread after every 'visible' action in main threads
+    // disallowed to modify any state
+    void invariant()
+    {
+    }
+};
+
+int main()
+{
+    rl::test_params params;
+    //params.search_type = rl::sched_full;
+    //params.iteration_count = 100000000;
+    params.search_type = rl::sched_random;
+    params.iteration_count = 1000000;
+
+    rl::simulate<rw_lock_test<2, 2>>(params);
+    rl::simulate<rw_lock_test<1, 2>>(params);
+    rl::simulate<rw_lock_test<2, 1>>(params);
+}
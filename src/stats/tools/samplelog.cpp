@@ -0,0 +1,110 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  Offline reader of lpt::stats::sample_log files:
+ *
+ *      samplelog csv   FILE     rows as CSV, with a header
+ *      samplelog stats FILE     exact percentiles of every column
+ *
+ */
+
+#include <lpt/iostream.hpp>
+#include <lpt/sample_log.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+void to_csv(lpt::stats::sample_log::reader& log)
+{
+    const auto& names(log.names());
+    for (std::size_t i = 0; i < names.size(); ++i) {
+        std::cout << (i ? "," : "");
+        lpt::csv_quote(std::cout, names[i]);
+    }
+    std::cout << '\n';
+
+    std::cout.precision(std::numeric_limits<double>::max_digits10);
+    lpt::stats::sample_log::reader::columns_t block;
+    while (log.read(block)) {
+        const std::size_t rows(block.empty() ? 0 : block[0].size());
+        for (std::size_t r = 0; r < rows; ++r) {
+            for (std::size_t c = 0; c < block.size(); ++c) {
+                std::cout << (c ? "," : "") << block[c][r];
+            }
+            std::cout << '\n';
+        }
+    }
+}
+
+// Nearest rank
+double percentile(const std::vector<double>& sorted, double pct)
+{
+    const auto rank(static_cast<std::size_t>(std::ceil(pct / 100 * static_cast<double>(sorted.size()))));
+    return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+void to_stats(lpt::stats::sample_log::reader& log)
+{
+    auto columns(log.read_all());
+
+    std::cout << "Name, samples, min, max, mean, stddev, p50, p90, p99, p99.9, p99.99\n";
+    for (std::size_t c = 0; c < columns.size(); ++c) {
+        auto& values(columns[c]);
+        lpt::csv_quote(std::cout, log.names()[c]);
+        std::cout << ", " << values.size();
+        if (values.empty()) {
+            std::cout << '\n';
+            continue;
+        }
+        std::sort(values.begin(), values.end());
+
+        double mean(0), m2(0);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            const double delta(values[i] - mean);
+            mean += delta / static_cast<double>(i + 1);
+            m2   += delta * (values[i] - mean);
+        }
+        const double stddev(values.size() > 1 ? std::sqrt(m2 / static_cast<double>(values.size() - 1)) : 0);
+
+        std::cout << ", " << values.front()
+                  << ", " << values.back()
+                  << ", " << mean
+                  << ", " << stddev;
+        for (const double pct : {50.0, 90.0, 99.0, 99.9, 99.99}) {
+            std::cout << ", " << percentile(values, pct);
+        }
+        std::cout << '\n';
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3 || (std::strcmp(argv[1], "csv") != 0 && std::strcmp(argv[1], "stats") != 0)) {
+        std::cerr << "Usage: " << argv[0] << " csv|stats FILE\n";
+        return EXIT_FAILURE;
+    }
+
+    try {
+        lpt::stats::sample_log::reader log(argv[2]);
+        if (std::strcmp(argv[1], "csv") == 0) {
+            to_csv(log);
+        } else {
+            to_stats(log);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << argv[0] << ": " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
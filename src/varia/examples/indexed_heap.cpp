@@ -0,0 +1,106 @@
+/*
+ *  $Id: $
+ *
+ *  Copyright 2026 Aurelian Melinte.
+ *  Released under GPL 3.0 or later.
+ *
+ *  indexed_heap against a std::multiset: random push/update/erase/pop.
+ *
+ */
+
+#include <lpt/indexed_heap.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+
+// Keys drawn from a small range: plenty of ties
+template <typename COMPARE_T, std::size_t ARITY>
+void check_random(unsigned seed, int ops)
+{
+    using heap_t   = lpt::indexed_heap<int, COMPARE_T, ARITY>;
+    using handle_t = typename heap_t::handle_t;
+
+    heap_t                        heap;
+    std::multiset<int, COMPARE_T> ref;
+    std::map<handle_t, int>       live;   // handle -> key
+    std::vector<handle_t>         dead;
+
+    std::mt19937                    rng(seed);
+    std::uniform_int_distribution<> key(0, 999);
+    std::uniform_int_distribution<> op(0, 9);
+
+    const auto any_live([&]() {
+        auto it(live.begin());
+        std::advance(it, std::uniform_int_distribution<std::size_t>(0, live.size() - 1)(rng));
+        return it;
+    });
+
+    for (int i = 0; i < ops; ++i) {
+        const int o(op(rng));
+        if (live.empty() || o < 4) {
+            const int  k(key(rng));
+            const auto h(heap.push(k));
+            assert( ! live.count(h));
+            live[h] = k;
+            ref.insert(k);
+        } else if (o < 6) {
+            auto       it(any_live());
+            const int  k(key(rng));
+            ref.erase(ref.find(it->second));
+            ref.insert(k);
+            heap.update(it->first, k);
+            it->second = k;
+        } else if (o < 8) {
+            auto it(any_live());
+            ref.erase(ref.find(it->second));
+            heap.erase(it->first);
+            dead.push_back(it->first);
+            live.erase(it);
+        } else {
+            const auto h(heap.top_handle());
+            assert(live.count(h) && live[h] == heap.top());
+            ref.erase(ref.begin());
+            heap.pop();
+            dead.push_back(h);
+            live.erase(h);
+        }
+
+        assert(heap.size() == ref.size());
+        assert(heap.empty() || heap.top() == *ref.begin());
+    }
+
+    for (const auto& [h, k] : live) {
+        assert(heap.contains(h));
+        assert(heap[h] == k);
+    }
+    for (const auto h : dead) {
+        assert(live.count(h) || ! heap.contains(h));   // freed handles are reused
+    }
+
+    // Drains in order
+    for (auto it = ref.begin(); it != ref.end(); ++it) {
+        assert(heap.top() == *it);
+        heap.pop();
+    }
+    assert(heap.empty());
+}
+
+int main()
+{
+    for (unsigned seed = 1; seed <= 20; ++seed) {
+        check_random<std::less<int>, 4>(seed, 20'000);
+        check_random<std::less<int>, 2>(seed, 20'000);
+        check_random<std::greater<int>, 8>(seed, 20'000);
+    }
+
+    std::cout << "OK\n";
+    return 0;
+}
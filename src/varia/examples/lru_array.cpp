@@ -8,14 +8,24 @@
  *
  */
 
+#include <lpt/concurrent_lru_array.hpp>
 #include <lpt/lru_array.hpp>
+#include <lpt/mapped_lru_array.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <coroutine>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <system_error>
 #include <thread>
-
-using namespace std::chrono_literals;
+#include <vector>
 
 
 struct Item
@@ -30,6 +40,275 @@ struct Item
     }
 }; 
 
+// Same contract whatever the eviction policy
+template <template <std::size_t> class POLICY>
+void check_policy()
+{
+    lpt::lru_array<int, int, 8, POLICY> lru;
+    for (int i = 0; i < 100; ++i) {
+        lru.push(i % 13, i);
+        lru.find(i % 3);
+        assert(lru.size() == static_cast<size_t>(std::min(i + 1, 8)));
+        assert(*lru.find(i % 13) == i);
+    }
+    assert(lru.erase(99 % 13));
+    assert(lru.size() == 7);
+}
+
+// A one time key does not displace a popular one
+void check_tinylfu()
+{
+    lpt::lru_array<int, int, 4, lpt::eviction::lru, lpt::admission::tinylfu> lru;
+    for (int n = 0; n < 3; ++n) {
+        for (int i = 0; i < 4; ++i) {
+            lru.push(i, i);
+        }
+    }
+    assert( ! lru.push(100, 100));
+    assert( ! lru.contains(100));
+    assert(lru.size() == 4);
+}
+
+// A costly key must beat every item it would evict, not only the first
+void check_tinylfu_cost()
+{
+    lpt::lru_array<int, int, 8, lpt::eviction::lru, lpt::admission::tinylfu> lru(100);
+    lru.push(1, 1, 10);               // cold, next to go
+    for (int i = 2; i < 6; ++i) {
+        lru.push(i, i, 20);
+    }
+    for (int n = 0; n < 5; ++n) {
+        for (int i = 2; i < 6; ++i) {
+            lru.find(i);
+        }
+    }
+    lru.find(9);
+    lru.find(9);                      // warmer than 1, colder than 2 and 3
+
+    assert( ! lru.push(9, 9, 50));    // would evict 1, 2 and 3
+    assert(lru.size() == 5);
+    assert(lru.contains(1) && lru.contains(2) && lru.contains(3));
+    assert(lru.total_cost() == 90);
+
+    assert(lru.push(9, 9, 20));       // evicts 1 only
+    assert( ! lru.contains(1) && lru.contains(2));
+}
+
+// Evict until the total cost fits; drop expired items
+void check_cost_ttl()
+{
+    using namespace std::chrono_literals;
+
+    lpt::lru_array<int, int, 8> lru(100);
+    assert(lru.push(1, 1, 40));
+    assert(lru.push(2, 2, 40));
+    assert(lru.push(3, 3, 40));       // evicts 1
+    assert( ! lru.contains(1));
+    assert(lru.total_cost() == 80);
+    assert(lru.push(4, 4, 100));      // evicts 2 and 3
+    assert(lru.size() == 1);
+    assert( ! lru.push(5, 5, 101));   // never fits
+
+    lru.clear();
+    lru.push(1, 1, 0, 20ms);
+    lru.push(2, 2, 0, 20ms);
+    lru.push(3, 3);
+    assert(lru.find(1) != nullptr);
+    std::this_thread::sleep_for(50ms);
+    assert(lru.find(1) == nullptr);   // lazy
+    assert(lru.size() == 2);
+    assert(lru.expire(8) == 1);       // sweep
+    assert(lru.size() == 1);
+    assert(lru.contains(3));
+}
+
+// Random pushes and updates never leave the total cost over budget
+template <template <std::size_t> class POLICY>
+void check_cost_budget()
+{
+    lpt::lru_array<int, int, 8, POLICY> lru(100);
+    for (int i = 0; i < 4; ++i) {
+        assert(lru.push(i, i, 20));
+    }
+    assert(lru.push(0, 0, 60));       // update: evicts others
+    assert(lru.total_cost() <= lru.max_cost());
+    assert(lru.contains(0));
+    assert( ! lru.push(0, 1, 101));   // update that never fits: no stale value
+    assert( ! lru.contains(0));
+    assert(lru.find(0) == nullptr);
+
+    std::minstd_rand rng(42);
+    for (int i = 0; i < 10'000; ++i) {
+        const int key(static_cast<int>(rng() % 16));
+        lru.push(key, i, rng() % 61);
+        lru.find(static_cast<int>(rng() % 16));
+        assert(lru.total_cost() <= lru.max_cost());
+        assert(lru.contains(key));
+    }
+}
+
+// An update that evicts others keeps the updated key's policy state: a
+// hot key still survives a scan. Not for plain LRU, which a scan flushes.
+template <template <std::size_t> class POLICY>
+void check_policy_state()
+{
+    lpt::lru_array<int, int, 8, POLICY> lru(100);
+    for (int i = 0; i < 9; ++i) {
+        lru.push(i, i, 10);           // 0 evicted: a ghost for 2Q and S3-FIFO
+    }
+    lru.push(0, 0, 10);               // seen again
+    for (int n = 0; n < 3; ++n) {
+        lru.find(0);
+    }
+    assert(lru.push(0, 1, 60));       // update: evicts others
+    for (int i = 100; i < 108; ++i) {
+        lru.push(i, i, 1);            // one time keys
+    }
+    assert(lru.contains(0));
+}
+
+// Counters compile away by default
+void check_counters()
+{
+    using namespace std::chrono_literals;
+    using lpt::lru_counters::event;
+
+    static_assert(sizeof(lpt::lru_array<int, int, 4>) == sizeof(lpt::lru_array<int, int, 4, lpt::eviction::lru, lpt::admission::always, lpt::lru_counters::none>));
+
+    lpt::lru_array<int, int, 4, lpt::eviction::lru, lpt::admission::always, lpt::lru_counters::relaxed> lru;
+    for (int i = 0; i < 6; ++i) {
+        lru.push(i, i);               // 0 and 1 evicted
+    }
+    lru.push(5, 50);
+    lru.push(6, 6, 0, 1ms);           // 2 evicted
+    assert(lru.find(5) && lru.find(4));
+    assert( ! lru.find(0));
+    std::this_thread::sleep_for(50ms);
+    assert( ! lru.find(6));           // expired, and a miss
+
+    const auto c(lru.counters());
+    assert(c[event::hit] == 2 && c[event::miss] == 2);
+    assert(c[event::eviction] == 3 && c[event::update] == 1 && c[event::expired] == 1);
+    assert(c.hit_ratio() == 0.5);
+
+    lpt::concurrent_lru_array<int, int, 64, 4, std::mutex,
+                              lpt::eviction::lru, lpt::admission::always, lpt::lru_counters::relaxed> cache;
+    cache.push(1, 1);
+    cache.get(1);
+    cache.get(2);
+    assert((cache.counters() - lpt::lru_counters::snapshot{}).lookups() == 2);
+    std::cout << cache.counters();
+}
+
+// Fire and forget coroutine
+struct task
+{
+    struct promise_type
+    {
+        task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+// Concurrent misses on one key run the loader once
+void check_get_or_load()
+{
+    using namespace std::chrono_literals;
+
+    lpt::concurrent_lru_array<int, int, 64, 4> cache;
+    std::atomic<int> loads(0);
+    auto slowLoad = [&loads](int key) {
+        ++loads;
+        std::this_thread::sleep_for(50ms);
+        return key * 10;
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&] { assert(cache.get_or_load(7, slowLoad) == 70); });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    assert(loads == 1);
+    assert(cache.get(7) == 70);
+
+    // Failed loads are not cached
+    try {
+        cache.get_or_load(8, [](int) -> int { throw std::runtime_error("load"); });
+        assert(false);
+    } catch (const std::runtime_error&) {}
+    assert( ! cache.contains(8));
+
+    // Coroutines: the second one parks until the thread's load lands
+    int results(0);
+    auto coro = [&](int key) -> task {
+        results += co_await cache.async_get_or_load(key, slowLoad);
+    };
+    std::thread loader([&] { cache.get_or_load(9, slowLoad); });
+    std::this_thread::sleep_for(10ms);
+    coro(9);
+    loader.join();
+    coro(9);
+    assert(results == 180);
+    assert(loads == 2);
+}
+
+// A cleanly closed image is reused; a damaged one is not
+template <template <std::size_t> class POLICY>
+void check_mapped()
+{
+    using namespace std::chrono_literals;
+    using mapped_t = lpt::mapped_lru_array<int, int, 64, POLICY>;
+
+    const std::string path("/tmp/lpt-lru_array.img");
+    std::remove(path.c_str());
+    {
+        mapped_t lru(path);
+        assert( ! lru.warm());
+        bool busy(false);
+        try {
+            mapped_t other(path);
+        } catch (const std::system_error&) {
+            busy = true;
+        }
+        assert(busy);
+        for (int i = 0; i < 100; ++i) {
+            lru->push(i, i * 2);
+        }
+        lru->push(1000, 1, 0, 1h);
+        lru->push(1001, 1, 0, 1ms);
+    }
+    {
+        mapped_t lru(path);
+        assert(lru.warm());
+        assert(lru->size() == 64);
+        assert(*lru->find(99) == 198);
+        assert( ! lru->contains(0));
+        assert(lru->contains(1000));
+        std::this_thread::sleep_for(50ms);
+        assert( ! lru->contains(1001));
+    }
+    {
+        lpt::mapped_lru_array<unsigned, int, 64, POLICY> otherType(path);   // same sizes
+        assert( ! otherType.warm());
+    }
+    {
+        std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(200);
+        f.put('x');
+    }
+    {
+        mapped_t lru(path);
+        assert( ! lru.warm());
+        assert(lru->empty());
+    }
+    std::remove(path.c_str());
+}
+
 int main()
 {
     lpt::lru_array<std::string, Item, 5> lru;
@@ -39,27 +318,22 @@ int main()
     lru.push("A", {"A", 0});
     static_assert(lru.max_size() == 5);
     assert(lru.size() == 1);
-    std::this_thread::sleep_for(10ms);
 
     lru.push("B", {"B", 1});
     static_assert(lru.max_size() == 5);
     assert(lru.size() == 2);
-    std::this_thread::sleep_for(10ms);
 
     lru.push("C", {"C", 2});
     static_assert(lru.max_size() == 5);
     assert(lru.size() == 3);
-    std::this_thread::sleep_for(10ms);
 
     lru.push("D", {"D", 3});
     static_assert(lru.max_size() == 5);
     assert(lru.size() == 4);
-    std::this_thread::sleep_for(10ms);
 
     lru.push("E", {"E", 4});
     static_assert(lru.max_size() == 5);
     assert(lru.size() == 5);
-    std::this_thread::sleep_for(10ms);
 
     lru.push("A", {"A", 0});
     static_assert(lru.max_size() == 5);
@@ -67,14 +341,50 @@ int main()
     lru.push("A", {"A", 5});
     static_assert(lru.max_size() == 5);
     assert(lru.size() == 5);
-    std::this_thread::sleep_for(10ms);
 
     lru.push("F", {"F", 6});  // replace B: A(5)F(6)C(2)D(3)E(4)
     static_assert(lru.max_size() == 5);
     assert(lru.size() == 5);
-    std::this_thread::sleep_for(10ms);
+
+    assert( ! lru.contains("B"));
+    assert(lru.find("B") == nullptr);
+
+    assert(lru.find("C")->_val == 2); // refresh C: D is now the oldest
+    lru.push("G", {"G", 7});          // replace D: A(5)F(6)C(2)G(7)E(4)
+    assert(lru.size() == 5);
+    assert( ! lru.contains("D"));
+    assert(lru.get("G")->_val == 7);
+
+    assert(lru.erase("E"));
+    assert( ! lru.erase("E"));
+    assert(lru.size() == 4);
+    lru.push("H", {"H", 8});          // reuse E's slot, nothing evicted
+    assert(lru.size() == 5);
+    assert(lru.contains("A"));
 
     std::cout << '\n' << lru << '\n';
 
+    check_policy<lpt::eviction::lru>();
+    check_policy<lpt::eviction::clock>();
+    check_policy<lpt::eviction::sieve>();
+    check_policy<lpt::eviction::two_q>();
+    check_policy<lpt::eviction::s3fifo>();
+    check_tinylfu();
+    check_tinylfu_cost();
+    check_cost_ttl();
+    check_cost_budget<lpt::eviction::lru>();
+    check_cost_budget<lpt::eviction::clock>();
+    check_cost_budget<lpt::eviction::sieve>();
+    check_cost_budget<lpt::eviction::two_q>();
+    check_cost_budget<lpt::eviction::s3fifo>();
+    check_policy_state<lpt::eviction::clock>();
+    check_policy_state<lpt::eviction::sieve>();
+    check_policy_state<lpt::eviction::two_q>();
+    check_policy_state<lpt::eviction::s3fifo>();
+    check_counters();
+    check_get_or_load();
+    check_mapped<lpt::eviction::lru>();
+    check_mapped<lpt::eviction::s3fifo>();
+
     return EXIT_SUCCESS;
 }